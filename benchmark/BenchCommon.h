@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+
+// 基准公共设施：计时、统计与表格输出。
+// 所有 suite 共用同一套输出格式，便于不同提交之间直接 diff 结果。
+
+struct BenchOptions {
+    QVector<int> sizes;
+    int iterations = 20;
+    bool show = false;  // 是否 show() 被测窗口（offscreen 平台下也可开启）
+};
+
+struct BenchStats {
+    double medianMs = 0.0;
+    double p95Ms = 0.0;
+    double minMs = 0.0;
+};
+
+// 先执行一次预热，再采样 iterations 次
+template <typename Fn>
+BenchStats measure(int iterations, Fn &&fn) {
+    fn();
+    QVector<qint64> samples;
+    samples.reserve(iterations);
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; ++i) {
+        timer.start();
+        fn();
+        samples.append(timer.nsecsElapsed());
+    }
+    std::sort(samples.begin(), samples.end());
+
+    BenchStats stats;
+    if (samples.isEmpty()) {
+        return stats;
+    }
+    const int p95 = qBound(0, static_cast<int>(samples.size() * 0.95), samples.size() - 1);
+    stats.medianMs = samples.at(samples.size() / 2) / 1e6;
+    stats.p95Ms = samples.at(p95) / 1e6;
+    stats.minMs = samples.constFirst() / 1e6;
+    return stats;
+}
+
+inline void printHeader(QTextStream &out, const QString &sizeLabel) {
+    out << QStringLiteral("%1 %2 %3 %4 %5\n")
+               .arg(QStringLiteral("case"), -28)
+               .arg(sizeLabel, 10)
+               .arg(QStringLiteral("median(ms)"), 11)
+               .arg(QStringLiteral("p95(ms)"), 10)
+               .arg(QStringLiteral("min(ms)"), 10);
+    out.flush();
+}
+
+inline void printRow(QTextStream &out, const QString &name, int size, const BenchStats &stats) {
+    out << QStringLiteral("%1 %2 %3 %4 %5\n")
+               .arg(name, -28)
+               .arg(size, 10)
+               .arg(stats.medianMs, 11, 'f', 3)
+               .arg(stats.p95Ms, 10, 'f', 3)
+               .arg(stats.minMs, 10, 'f', 3);
+    out.flush();
+}
+
+int runWidgetsSuite(const BenchOptions &options);
+int runSelectorSuite(const BenchOptions &options);
+int runBacktrackSuite(const BenchOptions &options);
+int runParallelSuite(const BenchOptions &options);
@@ -0,0 +1,592 @@
+#include "BenchCommon.h"
+#include "UiPropertyReader.h"
+#include "UiQMLQuery.h"
+#include "UiSceneSnapshot.h"
+#include "UiTextIndex.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QQuickItem>
+#include <QScopedPointer>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+#include <QWidget>
+
+#include <functional>
+
+// selector suite：同一形状的 QQuickItem / QWidget / QObject 三棵树上
+// 执行同一组选择器，先校验三者结果（objectName 序列）一致，再分别计时。
+// 任一选择器结果不一致时返回非零退出码，可作为三个树特征类的一致性检查。
+// 最后把全部选择器交给 querySelectorMulti 单遍求值，校验结果与逐个查询
+// 一致，并与逐个查询的总耗时对比。
+// 结果窗口：同一选择器的全量查询、前 20 个（offset 5）与 limit = 1 计数，
+// 校验窗口结果是全量结果的对应切片。
+// 快照：同一组选择器在 UiSceneSnapshot 上的结果必须与实时查询一致，
+// 分别统计采集耗时与快照上的查询耗时。
+// 结果缓存：校验改动依赖属性后缓存失效，并对比缓存命中与不缓存的耗时。
+// 文本索引：UiTextIndex 的精确 / 包含查找与 findChildren 线性扫描对比，
+// 校验改名后索引随 notify 信号更新。
+// 批量读属性：UiPropertyReader 的紧凑表与逐对象按名 property() 对比。
+//
+// 树形状：root → section × S → row × 10 → field × 3（label / input / button），
+// 每个节点带 objectName 与动态属性 role。
+//
+// parallel suite：快照上的并行查询扩展性。同一形状的 QQuickItem / QObject 树
+// 采集为快照后，线程池线程数从 1 逐级翻倍到 QThread::idealThreadCount()，
+// 分别统计 querySelectorAllParallel 与并行文本搜索的耗时；
+// 每一级的结果都必须与单线程的快照查询完全一致。
+//
+// backtrack suite：对抗性回溯场景。size 为深度 / 宽度 D：
+//   链  root → n1 → … → nD，选择器 "%T[role='never'] %T %T … %T"
+//   扇  root 下 D 个兄弟，选择器 "%T[role='never'] ~ %T ~ … ~ %T"
+// 每个节点都命中最右侧 token，而最左侧 token 永远不匹配，未记忆化的
+// 回溯会枚举所有祖先（兄弟）组合，代价随 D 与链长指数增长；
+// 记忆化后应随 D × 链长线性增长。
+
+namespace {
+constexpr int kRowsPerSection = 10;
+constexpr int kFieldsPerRow = 3;
+
+struct SelectorCase {
+    QString name;
+    QString selector;  // %T 替换为各树的类型名
+    bool expectEmpty = false;
+};
+
+// 节点工厂：parent 为空时创建根节点
+using NodeFactory = std::function<QObject *(QObject *parent, const QString &name, const QString &role)>;
+
+QObject *buildTree(int sections, const NodeFactory &make) {
+    static const char *kFieldRoles[kFieldsPerRow] = {"label", "input", "button"};
+    QObject *root = make(nullptr, QStringLiteral("root"), QStringLiteral("root"));
+    for (int s = 0; s < sections; ++s) {
+        const QString sectionName = QStringLiteral("sec%1").arg(s);
+        QObject *section = make(root, sectionName, QStringLiteral("section"));
+        for (int r = 0; r < kRowsPerSection; ++r) {
+            const QString rowName = QStringLiteral("%1_row%2").arg(sectionName).arg(r);
+            QObject *row = make(section, rowName, QStringLiteral("row"));
+            for (int f = 0; f < kFieldsPerRow; ++f) {
+                make(row, QStringLiteral("%1_f%2").arg(rowName).arg(f), QString::fromLatin1(kFieldRoles[f]));
+            }
+        }
+    }
+    return root;
+}
+
+QObject *makeItem(QObject *parent, const QString &name, const QString &role) {
+    auto *item = new QQuickItem(static_cast<QQuickItem *>(parent));
+    item->setObjectName(name);
+    item->setProperty("role", role);
+    return item;
+}
+
+QObject *makeWidget(QObject *parent, const QString &name, const QString &role) {
+    auto *widget = new QWidget(static_cast<QWidget *>(parent));
+    widget->setObjectName(name);
+    widget->setProperty("role", role);
+    return widget;
+}
+
+QObject *makeObject(QObject *parent, const QString &name, const QString &role) {
+    auto *object = new QObject(parent);
+    object->setObjectName(name);
+    object->setProperty("role", role);
+    return object;
+}
+
+struct TreeUnderTest {
+    QString label;
+    QString typeName;
+    QmlQuerySelector::TreeKind kind;
+    QScopedPointer<QObject> root;
+};
+
+// 深度为 depth 的单链；根节点 role 为 anchor，其余为 link
+QObject *buildChain(int depth, const NodeFactory &make) {
+    QObject *root = make(nullptr, QStringLiteral("root"), QStringLiteral("anchor"));
+    QObject *parent = root;
+    for (int d = 1; d <= depth; ++d) {
+        parent = make(parent, QStringLiteral("n%1").arg(d), QStringLiteral("link"));
+    }
+    return root;
+}
+
+// 根节点下 width 个兄弟
+QObject *buildFan(int width, const NodeFactory &make) {
+    QObject *root = make(nullptr, QStringLiteral("root"), QStringLiteral("anchor"));
+    for (int i = 0; i < width; ++i) {
+        make(root, QStringLiteral("s%1").arg(i), QStringLiteral("link"));
+    }
+    return root;
+}
+
+// prefix 后接 count 个 "%T"，以 combinator 连接
+QString repeatedChain(const QString &prefix, const QString &combinator, int count) {
+    QString selector = prefix;
+    for (int i = 0; i < count; ++i) {
+        selector += combinator + QStringLiteral("%T");
+    }
+    return selector;
+}
+
+QStringList objectNames(const QList<QObject *> &objects) {
+    QStringList names;
+    names.reserve(objects.size());
+    for (QObject *obj : objects) {
+        names.append(obj->objectName());
+    }
+    return names;
+}
+}  // namespace
+
+int runSelectorSuite(const BenchOptions &options) {
+    const QList<SelectorCase> cases = {
+        {QStringLiteral("objectName"), QStringLiteral("%T[objectName='sec0_row9_f2']")},
+        {QStringLiteral("child chain"),
+         QStringLiteral("%T[role='section'] > %T[role='row'] > %T[role='button']")},
+        {QStringLiteral("adjacent"), QStringLiteral("%T[role='section'] %T[role='input'] + %T[role='button']")},
+        {QStringLiteral("sibling"), QStringLiteral("%T[role='label'] ~ %T[role='button']")},
+        {QStringLiteral("nth-child"), QStringLiteral("%T[role='row']:nth-child(2) > %T:nth-last-child(1)")},
+        {QStringLiteral("nth odd / first"), QStringLiteral("%T[role='row']:nth-child(odd) > %T:first-child")},
+        {QStringLiteral("nth-last -n+2"), QStringLiteral("%T[role='section'] > %T:nth-last-child(-n+2)")},
+        {QStringLiteral("comma union"), QStringLiteral("%T[objectName$='_row0_f0'], %T[role='section']:nth-child(1)")},
+        {QStringLiteral("has"), QStringLiteral("%T[role='row']:has(> %T[objectName='sec0_row3_f1'])")},
+        {QStringLiteral("has + not"),
+         QStringLiteral("%T[role='section']:has(%T[role='row'] + %T:nth-child(10)) %T:not([role='label'], [role='button'])")},
+        {QStringLiteral("enabled"), QStringLiteral("%T[role='row']:nth-child(3) > %T:enabled")},
+        {QStringLiteral("untyped prefix"), QStringLiteral("[role^='butt'][objectName^='sec0_']")},
+        {QStringLiteral("miss"), QStringLiteral("%T[role='row'] > %T[objectName*='missing']"), true},
+    };
+
+    QTextStream out(stdout);
+    printHeader(out, QStringLiteral("nodes"));
+
+    int mismatches = 0;
+    for (const int size : options.sizes) {
+        const int sections = qMax(1, size / (1 + kRowsPerSection * (1 + kFieldsPerRow)));
+        const int nodeCount = 1 + sections * (1 + kRowsPerSection * (1 + kFieldsPerRow));
+
+        TreeUnderTest trees[] = {
+            {QStringLiteral("quick"), QStringLiteral("Item"), QmlQuerySelector::TreeKind::Quick,
+             QScopedPointer<QObject>(buildTree(sections, makeItem))},
+            {QStringLiteral("widget"), QStringLiteral("QWidget"), QmlQuerySelector::TreeKind::Widget,
+             QScopedPointer<QObject>(buildTree(sections, makeWidget))},
+            {QStringLiteral("object"), QStringLiteral("QObject"), QmlQuerySelector::TreeKind::Object,
+             QScopedPointer<QObject>(buildTree(sections, makeObject))},
+        };
+
+        QVector<QList<QStringList>> perTree(3);  // 逐个查询的结果，供 multi 校验
+        for (const SelectorCase &c : cases) {
+            QStringList reference;
+            for (int i = 0; i < 3; ++i) {
+                TreeUnderTest &tree = trees[i];
+                QmlQuerySelector selector;
+                selector.setTreeKind(tree.kind);
+                const QString text = QString(c.selector).replace(QStringLiteral("%T"), tree.typeName);
+
+                QString error;
+                const QStringList names = objectNames(selector.querySelectorAll(tree.root.data(), text, &error));
+                perTree[i].append(names);
+                if (!error.isEmpty()) {
+                    qWarning().noquote() << tree.label << c.name << "failed:" << error;
+                    ++mismatches;
+                }
+                if (i == 0) {
+                    reference = names;
+                    if (names.isEmpty() != c.expectEmpty) {
+                        qWarning().noquote() << tree.label << c.name << "returned" << names.size() << "matches";
+                        ++mismatches;
+                    }
+                } else if (names != reference) {
+                    qWarning().noquote() << tree.label << c.name << "disagrees with" << trees[0].label
+                                         << ":" << names.size() << "vs" << reference.size() << "matches";
+                    ++mismatches;
+                }
+
+                printRow(out, QStringLiteral("%1: %2").arg(tree.label, c.name), nodeCount,
+                         measure(options.iterations, [&]() {
+                             selector.querySelectorAll(tree.root.data(), text);
+                         }));
+            }
+        }
+
+        for (TreeUnderTest &tree : trees) {
+            QmlQuerySelector selector;
+            selector.setTreeKind(tree.kind);
+            const QString text = QStringLiteral("%1[role='row'] > %1[role='input'], %1[role='section']").arg(tree.typeName);
+            SelectorRange page;
+            page.offset = 5;
+            page.limit = 20;
+            SelectorRange any;
+            any.limit = 1;
+
+            const QStringList all = objectNames(selector.querySelectorAll(tree.root.data(), text));
+            if (objectNames(selector.querySelectorAll(tree.root.data(), text, page)) != all.mid(5, 20)
+                || selector.countSelectorAll(tree.root.data(), text) != all.size()
+                || selector.countSelectorAll(tree.root.data(), text, any) != qMin(1, all.size())) {
+                qWarning().noquote() << tree.label << "window results disagree with the full query";
+                ++mismatches;
+            }
+
+            printRow(out, QStringLiteral("%1: window full").arg(tree.label), nodeCount,
+                     measure(options.iterations, [&]() {
+                         selector.querySelectorAll(tree.root.data(), text);
+                     }));
+            printRow(out, QStringLiteral("%1: window 5+20").arg(tree.label), nodeCount,
+                     measure(options.iterations, [&]() {
+                         selector.querySelectorAll(tree.root.data(), text, page);
+                     }));
+            printRow(out, QStringLiteral("%1: count exists").arg(tree.label), nodeCount,
+                     measure(options.iterations, [&]() {
+                         selector.countSelectorAll(tree.root.data(), text, any);
+                     }));
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            TreeUnderTest &tree = trees[i];
+            QStringList texts;
+            QSet<QString> properties;
+            for (const SelectorCase &c : cases) {
+                texts.append(QString(c.selector).replace(QStringLiteral("%T"), tree.typeName));
+                UiSnapshotQuery::requiredProperties(texts.last(), &properties);
+            }
+            QmlQuerySelector selector;
+            selector.setTreeKind(tree.kind);
+            const QList<QObject *> roots{tree.root.data()};
+
+            const auto snapshot = selector.snapshot(roots, properties);
+            UiSnapshotQuery query(snapshot);
+            for (int k = 0; k < texts.size(); ++k) {
+                QVector<int> hits;
+                QString error;
+                query.querySelectorAll(texts.at(k), SelectorRange(), &hits, &error);
+                QStringList names;
+                for (const int node : hits) {
+                    names.append(snapshot->objectName(node));
+                }
+                if (!error.isEmpty() || names != perTree[i].at(k)) {
+                    qWarning().noquote() << tree.label << "snapshot" << cases.at(k).name
+                                         << "disagrees with live query" << error;
+                    ++mismatches;
+                }
+            }
+
+            printRow(out, QStringLiteral("%1: snapshot capture").arg(tree.label), nodeCount,
+                     measure(options.iterations, [&]() {
+                         selector.snapshot(roots, properties);
+                     }));
+            printRow(out, QStringLiteral("%1: snapshot x%2").arg(tree.label).arg(texts.size()), nodeCount,
+                     measure(options.iterations, [&]() {
+                         for (const QString &text : texts) {
+                             query.querySelectorAll(text, SelectorRange(), nullptr);
+                         }
+                     }));
+        }
+
+        for (TreeUnderTest &tree : trees) {
+            QmlQuerySelector cached;
+            cached.setTreeKind(tree.kind);
+            cached.setResultCacheCapacity(64);
+            QmlQuerySelector uncached;
+            uncached.setTreeKind(tree.kind);
+            const QString text = QStringLiteral("%1[role='row'] > %1[role='button']").arg(tree.typeName);
+
+            // 命中后改动一个依赖属性，缓存必须失效并给出新结果
+            QObject *label = uncached.querySelector(tree.root.data(), QStringLiteral("[role='label']"));
+            const QStringList before = objectNames(cached.querySelectorAll(tree.root.data(), text));
+            cached.querySelectorAll(tree.root.data(), text);
+            label->setProperty("role", QStringLiteral("button"));
+            const QStringList after = objectNames(cached.querySelectorAll(tree.root.data(), text));
+            label->setProperty("role", QStringLiteral("label"));
+            const SelectorCacheStats stats = cached.resultCacheStats();
+            if (before != objectNames(uncached.querySelectorAll(tree.root.data(), text))
+                || after.size() != before.size() + 1
+                || objectNames(cached.querySelectorAll(tree.root.data(), text)) != before
+                || stats.hits != 1 || stats.misses != 2) {
+                qWarning().noquote() << tree.label << "result cache is stale or missed an invalidation";
+                ++mismatches;
+            }
+
+            printRow(out, QStringLiteral("%1: cache off").arg(tree.label), nodeCount,
+                     measure(options.iterations, [&]() {
+                         uncached.querySelectorAll(tree.root.data(), text);
+                     }));
+            printRow(out, QStringLiteral("%1: cache hit").arg(tree.label), nodeCount,
+                     measure(options.iterations, [&]() {
+                         cached.querySelectorAll(tree.root.data(), text);
+                     }));
+        }
+
+        for (TreeUnderTest &tree : trees) {
+            UiTextIndex index({QStringLiteral("objectName")});
+            const QList<QObject *> roots{tree.root.data()};
+            const QString name = QStringLiteral("sec%1_row9_f2").arg(sections - 1);
+            const auto linearScan = [&]() -> QObject * {
+                const auto objs = tree.root->findChildren<QObject *>();
+                for (QObject *obj : objs) {
+                    const QVariant v = obj->property("objectName");
+                    if (v.isValid() && v.toString() == name) {
+                        return obj;
+                    }
+                }
+                return nullptr;
+            };
+
+            // 改名后索引必须随 notify 信号更新
+            QObject *expected = linearScan();
+            QObject *found = index.find(roots, name);
+            bool renamed = false;
+            if (expected) {
+                expected->setObjectName(name + QStringLiteral("_renamed"));
+                renamed = !index.find(roots, name)
+                          && index.find(roots, QStringLiteral("ROW9_F2_RENAMED"), UiTextIndex::Match::Contains,
+                                        Qt::CaseInsensitive) == expected;
+                expected->setObjectName(name);
+            }
+            if (!expected || found != expected || !renamed || index.find(roots, name) != expected) {
+                qWarning().noquote() << tree.label << "text index disagrees with linear scan";
+                ++mismatches;
+            }
+
+            printRow(out, QStringLiteral("%1: text linear").arg(tree.label), nodeCount,
+                     measure(options.iterations, [&]() {
+                         linearScan();
+                     }));
+            printRow(out, QStringLiteral("%1: text index").arg(tree.label), nodeCount,
+                     measure(options.iterations, [&]() {
+                         index.find(roots, name);
+                     }));
+            printRow(out, QStringLiteral("%1: text contains").arg(tree.label), nodeCount,
+                     measure(options.iterations, [&]() {
+                         index.find(roots, QStringLiteral("ROW9_F2"), UiTextIndex::Match::Contains, Qt::CaseInsensitive);
+                     }));
+        }
+
+        for (TreeUnderTest &tree : trees) {
+            const QStringList columns{QStringLiteral("objectName"), QStringLiteral("role"), QStringLiteral("enabled")};
+            QVector<QObject *> objects{tree.root.data()};
+            for (QObject *obj : tree.root->findChildren<QObject *>()) {
+                objects.append(obj);
+            }
+            const auto byName = [&]() {
+                QJsonArray rows;
+                for (QObject *obj : objects) {
+                    QJsonArray row;
+                    for (const QString &name : columns) {
+                        row.append(QJsonValue::fromVariant(obj->property(name.toLatin1().constData())));
+                    }
+                    rows.append(row);
+                }
+                return rows;
+            };
+
+            UiPropertyReader reader;
+            if (reader.readTable(objects, columns).value(QStringLiteral("rows")).toArray() != byName()) {
+                qWarning().noquote() << tree.label << "property table disagrees with QObject::property()";
+                ++mismatches;
+            }
+
+            printRow(out, QStringLiteral("%1: read by name").arg(tree.label), nodeCount,
+                     measure(options.iterations, [&]() {
+                         byName();
+                     }));
+            printRow(out, QStringLiteral("%1: read table").arg(tree.label), nodeCount,
+                     measure(options.iterations, [&]() {
+                         reader.readTable(objects, columns);
+                     }));
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            TreeUnderTest &tree = trees[i];
+            QStringList texts;
+            for (const SelectorCase &c : cases) {
+                texts.append(QString(c.selector).replace(QStringLiteral("%T"), tree.typeName));
+            }
+            QmlQuerySelector selector;
+            selector.setTreeKind(tree.kind);
+
+            QStringList errors;
+            const auto multi = selector.querySelectorMulti(tree.root.data(), texts, &errors);
+            for (int k = 0; k < texts.size(); ++k) {
+                if (!errors.at(k).isEmpty() || objectNames(multi.at(k)) != perTree[i].at(k)) {
+                    qWarning().noquote() << tree.label << "multi" << cases.at(k).name << "disagrees with single query"
+                                         << errors.at(k);
+                    ++mismatches;
+                }
+            }
+
+            printRow(out, QStringLiteral("%1: sequential x%2").arg(tree.label).arg(texts.size()), nodeCount,
+                     measure(options.iterations, [&]() {
+                         for (const QString &text : texts) {
+                             selector.querySelectorAll(tree.root.data(), text);
+                         }
+                     }));
+            printRow(out, QStringLiteral("%1: multi x%2").arg(tree.label).arg(texts.size()), nodeCount,
+                     measure(options.iterations, [&]() {
+                         selector.querySelectorMulti(tree.root.data(), texts);
+                     }));
+            printRow(out, QStringLiteral("%1: multi first x%2").arg(tree.label).arg(texts.size()), nodeCount,
+                     measure(options.iterations, [&]() {
+                         selector.querySelectorMulti(tree.root.data(), texts, nullptr, true);
+                     }));
+        }
+    }
+
+    if (mismatches > 0) {
+        qWarning() << mismatches << "selector conformance failures";
+        return 1;
+    }
+    return 0;
+}
+
+int runBacktrackSuite(const BenchOptions &options) {
+    struct Shape {
+        QString label;
+        QString combinator;
+        QObject *(*build)(int, const NodeFactory &);
+    };
+    const Shape shapes[] = {
+        {QStringLiteral("descendant"), QStringLiteral(" "), buildChain},
+        {QStringLiteral("sibling"), QStringLiteral(" ~ "), buildFan},
+    };
+    const int chainLengths[] = {2, 4, 6};
+
+    QTextStream out(stdout);
+    printHeader(out, QStringLiteral("depth"));
+
+    int mismatches = 0;
+    for (const int size : options.sizes) {
+        for (const Shape &shape : shapes) {
+            TreeUnderTest trees[] = {
+                {QStringLiteral("quick"), QStringLiteral("Item"), QmlQuerySelector::TreeKind::Quick,
+                 QScopedPointer<QObject>(shape.build(size, makeItem))},
+                {QStringLiteral("widget"), QStringLiteral("QWidget"), QmlQuerySelector::TreeKind::Widget,
+                 QScopedPointer<QObject>(shape.build(size, makeWidget))},
+                {QStringLiteral("object"), QStringLiteral("QObject"), QmlQuerySelector::TreeKind::Object,
+                 QScopedPointer<QObject>(shape.build(size, makeObject))},
+            };
+
+            for (const int length : chainLengths) {
+                // 链上最左侧 token 永不匹配：结果必为空，但每个节点都会触发回溯
+                const QString miss = repeatedChain(QStringLiteral("%T[role='never']"), shape.combinator, length);
+                // 链式场景下最左侧锚定根节点：深度不小于 length 的节点全部命中
+                const QString hit = repeatedChain(QStringLiteral("%T[role='anchor']"), shape.combinator, length);
+                const int expectedHits = shape.build == buildChain ? qMax(0, size - length + 1) : -1;
+
+                for (TreeUnderTest &tree : trees) {
+                    QmlQuerySelector selector;
+                    selector.setTreeKind(tree.kind);
+                    const QString missText = QString(miss).replace(QStringLiteral("%T"), tree.typeName);
+                    const QString hitText = QString(hit).replace(QStringLiteral("%T"), tree.typeName);
+
+                    QString error;
+                    const int missCount = selector.querySelectorAll(tree.root.data(), missText, &error).size();
+                    const int hitCount = selector.querySelectorAll(tree.root.data(), hitText, &error).size();
+                    if (!error.isEmpty() || missCount != 0 || (expectedHits >= 0 && hitCount != expectedHits)) {
+                        qWarning().noquote() << tree.label << shape.label << length << "unexpected result:" << missCount
+                                             << hitCount << error;
+                        ++mismatches;
+                    }
+
+                    printRow(out, QStringLiteral("%1: %2 x%3").arg(tree.label, shape.label).arg(length), size,
+                             measure(options.iterations, [&]() {
+                                 selector.querySelectorAll(tree.root.data(), missText);
+                             }));
+                }
+            }
+        }
+    }
+
+    if (mismatches > 0) {
+        qWarning() << mismatches << "backtrack suite failures";
+        return 1;
+    }
+    return 0;
+}
+
+int runParallelSuite(const BenchOptions &options) {
+    const QStringList selectors{
+        QStringLiteral("%T[role='section'] > %T[role='row'] > %T[role='button']"),
+        QStringLiteral("%T[role='row']:nth-child(odd) %T[role='input'] + %T"),
+        QStringLiteral("%T[objectName$='_f2'], %T[role='label']:not([objectName*='row1'])"),
+    };
+    QVector<int> threadCounts;
+    const int ideal = qMax(1, QThread::idealThreadCount());
+    for (int t = 1; t < ideal; t *= 2) {
+        threadCounts.append(t);
+    }
+    threadCounts.append(ideal);
+
+    QTextStream out(stdout);
+    printHeader(out, QStringLiteral("nodes"));
+
+    int mismatches = 0;
+    for (const int size : options.sizes) {
+        const int sections = qMax(1, size / (1 + kRowsPerSection * (1 + kFieldsPerRow)));
+        const int nodeCount = 1 + sections * (1 + kRowsPerSection * (1 + kFieldsPerRow));
+
+        TreeUnderTest trees[] = {
+            {QStringLiteral("quick"), QStringLiteral("Item"), QmlQuerySelector::TreeKind::Quick,
+             QScopedPointer<QObject>(buildTree(sections, makeItem))},
+            {QStringLiteral("object"), QStringLiteral("QObject"), QmlQuerySelector::TreeKind::Object,
+             QScopedPointer<QObject>(buildTree(sections, makeObject))},
+        };
+
+        for (TreeUnderTest &tree : trees) {
+            QStringList texts;
+            QSet<QString> properties;
+            for (const QString &selector : selectors) {
+                texts.append(QString(selector).replace(QStringLiteral("%T"), tree.typeName));
+                UiSnapshotQuery::requiredProperties(texts.last(), &properties);
+            }
+            const QString needle = QStringLiteral("sec%1_row5_f1").arg(sections / 2);
+            QmlQuerySelector selector;
+            selector.setTreeKind(tree.kind);
+            const auto snapshot = selector.snapshot({tree.root.data()}, properties);
+            UiSnapshotQuery query(snapshot);
+
+            QVector<QVector<int>> reference;
+            for (const QString &text : texts) {
+                QVector<int> hits;
+                query.querySelectorAll(text, SelectorRange(), &hits);
+                reference.append(hits);
+            }
+            QVector<int> textReference;
+            query.findText(needle, {QStringLiteral("objectName"), QStringLiteral("role")}, &textReference);
+
+            for (const int threads : threadCounts) {
+                QThreadPool pool;
+                pool.setMaxThreadCount(threads);
+                for (int k = 0; k < texts.size(); ++k) {
+                    QVector<int> hits;
+                    QString error;
+                    query.querySelectorAllParallel(texts.at(k), SelectorRange(), &hits, &error, &pool);
+                    if (!error.isEmpty() || hits != reference.at(k)) {
+                        qWarning().noquote() << tree.label << "parallel x" << threads << texts.at(k)
+                                             << "disagrees with the sequential snapshot query" << error;
+                        ++mismatches;
+                    }
+                }
+
+                printRow(out, QStringLiteral("%1: select x%2 t%3").arg(tree.label).arg(texts.size()).arg(threads), nodeCount,
+                         measure(options.iterations, [&]() {
+                             for (const QString &text : texts) {
+                                 query.querySelectorAllParallel(text, SelectorRange(), nullptr, nullptr, &pool);
+                             }
+                         }));
+                printRow(out, QStringLiteral("%1: text t%2").arg(tree.label).arg(threads), nodeCount,
+                         measure(options.iterations, [&]() {
+                             query.findText(needle, {QStringLiteral("objectName"), QStringLiteral("role")}, nullptr, &pool);
+                         }));
+            }
+        }
+    }
+
+    if (mismatches > 0) {
+        qWarning() << mismatches << "parallel suite failures";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "BenchCommon.h"
+#include "FormGenerator.h"
+#include "UiAutomationProxyServer.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QJsonObject>
+#include <QMainWindow>
+
+// widgets suite：随控件数增长，测量 QtGenericUiAutomationHandler 的
+// resolve(objectName / text / selector)、dump_tree 与 execute_action 延迟。
+// 目标统一取生成表单中最后创建的字段，即线性扫描的最坏位置。
+
+namespace {
+QJsonObject target(const QString &kind, const QString &value) {
+    QJsonObject out;
+    out.insert(QStringLiteral("kind"), kind);
+    out.insert(QStringLiteral("value"), value);
+    return out;
+}
+
+void check(const QString &name, const QString &error) {
+    if (!error.isEmpty()) {
+        qWarning().noquote() << name << "failed:" << error;
+    }
+}
+}  // namespace
+
+int runWidgetsSuite(const BenchOptions &options) {
+    QTextStream out(stdout);
+    printHeader(out, QStringLiteral("widgets"));
+
+    for (const int size : options.sizes) {
+        const FormGeneratorConfig config = FormGeneratorConfig::forWidgetCount(size);
+        QMainWindow window;
+        window.setObjectName(QStringLiteral("generatedFormWindow"));
+        window.setCentralWidget(generateForm(config));
+        if (options.show) {
+            window.show();
+            QCoreApplication::processEvents();
+        }
+        const int widgetCount = window.findChildren<QWidget *>().size();
+
+        const int t = config.tabs - 1;
+        const int s = config.sections - 1;
+        const int d = config.nesting;
+        const int lastField = config.fieldsPerSection - 1;
+        const int lastLineEdit = lastField - lastField % 4;  // makeInput: field % 4 == 0 为 QLineEdit
+
+        const QJsonObject byName = target(QStringLiteral("objectName"), generatedFieldName(t, s, d, lastField, "input"));
+        const QJsonObject byText = target(QStringLiteral("text"), generatedFieldText(t, s, d, lastField));
+        const QJsonObject bySelector = target(QStringLiteral("selector"),
+                                              QStringLiteral("QScrollArea[objectName='gen_t%1_scroll'] QLineEdit[objectName='%2']")
+                                                  .arg(t).arg(generatedFieldName(t, s, d, lastLineEdit, "input")));
+        const QJsonObject missing = target(QStringLiteral("objectName"), QStringLiteral("gen_missing"));
+        const QJsonObject lineEdit = target(QStringLiteral("objectName"), generatedFieldName(t, s, d, lastLineEdit, "input"));
+        const QJsonObject apply = target(QStringLiteral("objectName"),
+                                         QStringLiteral("gen_t%1_s%2_d%3_apply").arg(t).arg(s).arg(d));
+
+        QtGenericUiAutomationHandler handler(&window);
+        QString error;
+
+        printRow(out, QStringLiteral("resolve objectName"), widgetCount, measure(options.iterations, [&]() {
+            error.clear();
+            handler.resolve(byName, &error);
+        }));
+        check(QStringLiteral("resolve objectName"), error);
+
+        printRow(out, QStringLiteral("resolve text"), widgetCount, measure(options.iterations, [&]() {
+            error.clear();
+            handler.resolve(byText, &error);
+        }));
+        check(QStringLiteral("resolve text"), error);
+
+        printRow(out, QStringLiteral("resolve selector"), widgetCount, measure(options.iterations, [&]() {
+            error.clear();
+            handler.resolve(bySelector, &error);
+        }));
+        check(QStringLiteral("resolve selector"), error);
+
+        printRow(out, QStringLiteral("resolve miss"), widgetCount, measure(options.iterations, [&]() {
+            handler.resolve(missing, nullptr);
+        }));
+
+        printRow(out, QStringLiteral("dump_tree"), widgetCount, measure(options.iterations, [&]() {
+            error.clear();
+            handler.dumpTree(&error);
+        }));
+        check(QStringLiteral("dump_tree"), error);
+
+        printRow(out, QStringLiteral("execute_action input"), widgetCount, measure(options.iterations, [&]() {
+            error.clear();
+            handler.executeAction(QStringLiteral("input"), lineEdit, QStringLiteral("bench"), &error);
+        }));
+        check(QStringLiteral("execute_action input"), error);
+
+        printRow(out, QStringLiteral("execute_action click"), widgetCount, measure(options.iterations, [&]() {
+            error.clear();
+            handler.executeAction(QStringLiteral("click"), apply, QJsonValue(), &error);
+        }));
+        check(QStringLiteral("execute_action click"), error);
+    }
+    return 0;
+}
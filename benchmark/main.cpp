@@ -0,0 +1,66 @@
+#include "BenchCommon.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+
+// 基准入口：--suite 选择场景，--sizes 给出逐级增长的规模。
+//   benchmark --suite widgets --sizes 1000,5000,20000 --offscreen
+//   benchmark --suite selector --sizes 1000,10000,50000 --offscreen
+//   benchmark --suite backtrack --sizes 32,128,512 --offscreen
+//   benchmark --suite parallel --sizes 10000,100000 --offscreen
+
+int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--offscreen") == 0 && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("UI automation benchmarks"));
+    parser.addHelpOption();
+    const QCommandLineOption suiteOpt(QStringLiteral("suite"), QStringLiteral("Benchmark suite: widgets | selector | backtrack | parallel."),
+                                      QStringLiteral("name"), QStringLiteral("widgets"));
+    const QCommandLineOption sizesOpt(QStringLiteral("sizes"), QStringLiteral("Comma separated problem sizes."),
+                                      QStringLiteral("list"), QStringLiteral("1000,5000,20000"));
+    const QCommandLineOption iterOpt(QStringLiteral("iterations"), QStringLiteral("Samples per case."),
+                                     QStringLiteral("n"), QStringLiteral("20"));
+    const QCommandLineOption showOpt(QStringLiteral("show"), QStringLiteral("Show the windows under test."));
+    const QCommandLineOption offscreenOpt(QStringLiteral("offscreen"), QStringLiteral("Run on the offscreen platform."));
+    parser.addOptions({suiteOpt, sizesOpt, iterOpt, showOpt, offscreenOpt});
+    parser.process(app);
+
+    BenchOptions options;
+    options.iterations = qMax(1, parser.value(iterOpt).toInt());
+    options.show = parser.isSet(showOpt);
+    const QStringList sizes = parser.value(sizesOpt).split(QLatin1Char(','), Qt::SkipEmptyParts);
+    for (const QString &size : sizes) {
+        const int value = size.trimmed().toInt();
+        if (value > 0) {
+            options.sizes.append(value);
+        }
+    }
+    if (options.sizes.isEmpty()) {
+        qCritical() << "--sizes must contain at least one positive size";
+        return 2;
+    }
+
+    const QString suite = parser.value(suiteOpt).trimmed().toLower();
+    if (suite == QStringLiteral("widgets")) {
+        return runWidgetsSuite(options);
+    }
+    if (suite == QStringLiteral("selector")) {
+        return runSelectorSuite(options);
+    }
+    if (suite == QStringLiteral("backtrack")) {
+        return runBacktrackSuite(options);
+    }
+    if (suite == QStringLiteral("parallel")) {
+        return runParallelSuite(options);
+    }
+    qCritical() << "unknown suite" << suite;
+    return 2;
+}
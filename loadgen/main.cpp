@@ -0,0 +1,428 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QTimer>
+#include <QUrl>
+#include <QVector>
+#include <QWebSocket>
+
+#include <algorithm>
+#include <cmath>
+
+// 压测工具：对 UiAutomationProxyServer 打开 N 个并发连接，按配置的比例
+// 重放 resolve / resolve_many / read_property / execute_action / dump_tree / screenshot，
+// 统计每个方法的吞吐（req/s）与 p50/p99/p999 延迟。
+//
+// 每个连接采用闭环模式：同一时刻只有一个请求在途，收到回复后立即发下一个，
+// 因此并发度 = 连接数，与真实客户端（脚本逐条等待回复）的行为一致。
+
+namespace {
+const QStringList kKnownMethods = {
+    QStringLiteral("resolve"),
+    QStringLiteral("resolve_many"),
+    QStringLiteral("read_property"),
+    QStringLiteral("execute_action"),
+    QStringLiteral("dump_tree"),
+    QStringLiteral("screenshot"),
+};
+
+struct MethodWeight {
+    QString method;
+    int weight = 0;
+};
+
+struct MethodStats {
+    QVector<qint64> latenciesUs;
+    int errors = 0;
+};
+
+// 运行期共享状态，全部在主线程事件循环中访问，无需加锁
+struct LoadContext {
+    QUrl url;
+    QString token;
+    QString app;
+    QString screenshotDir;
+    QVector<MethodWeight> mix;
+    int totalWeight = 0;
+    QRandomGenerator rng;
+    bool recording = false;  // 预热结束后才开始记录样本
+    bool stopping = false;
+    QHash<QString, MethodStats> stats;
+};
+
+QJsonObject makeTarget(const QString &kind, const QString &value) {
+    QJsonObject target;
+    target.insert(QStringLiteral("kind"), kind);
+    target.insert(QStringLiteral("value"), value);
+    return target;
+}
+
+// 两个 demo 程序共用 loginNameInput / loginButton 等 objectName，
+// resolve 针对各自最常用的定位方式：qml 走 selector，widgets 走 text。
+QJsonObject buildParams(const LoadContext &ctx, const QString &method, int clientIndex) {
+    const bool qml = ctx.app == QStringLiteral("qml");
+    QJsonObject params;
+    if (method == QStringLiteral("resolve")) {
+        params.insert(QStringLiteral("target"), qml
+            ? makeTarget(QStringLiteral("selector"), QStringLiteral("Button[objectName='loginButton']"))
+            : makeTarget(QStringLiteral("text"), QStringLiteral("登录")));
+    } else if (method == QStringLiteral("resolve_many")) {
+        // 页面对象层的典型用法：导航后一次解析登录页的全部控件
+        static const char *kNames[] = {"loginNameInput", "loginPasswordInput", "loginRoleCombo", "loginButton"};
+        QJsonArray targets;
+        for (const char *name : kNames) {
+            targets.append(qml
+                ? makeTarget(QStringLiteral("selector"), QStringLiteral("[objectName='%1']").arg(QLatin1String(name)))
+                : makeTarget(QStringLiteral("objectName"), QLatin1String(name)));
+        }
+        params.insert(QStringLiteral("targets"), targets);
+    } else if (method == QStringLiteral("read_property")) {
+        params.insert(QStringLiteral("target"), makeTarget(QStringLiteral("objectName"), QStringLiteral("loginNameInput")));
+        params.insert(QStringLiteral("property"), qml ? QStringLiteral("placeholderText") : QStringLiteral("text"));
+    } else if (method == QStringLiteral("execute_action")) {
+        params.insert(QStringLiteral("action"), QStringLiteral("input"));
+        params.insert(QStringLiteral("target"), makeTarget(QStringLiteral("objectName"), QStringLiteral("loginNameInput")));
+        params.insert(QStringLiteral("value"), QStringLiteral("loadgen-%1").arg(clientIndex));
+    } else if (method == QStringLiteral("screenshot")) {
+        params.insert(QStringLiteral("path"),
+                      QDir(ctx.screenshotDir).filePath(QStringLiteral("loadgen_%1.png").arg(clientIndex)));
+    }
+    return params;
+}
+
+bool parseMix(const QString &spec, QVector<MethodWeight> *mix, QString *error) {
+    const QStringList parts = spec.split(QLatin1Char(','), Qt::SkipEmptyParts);
+    for (const QString &part : parts) {
+        const QStringList kv = part.split(QLatin1Char('='));
+        const QString method = kv.value(0).trimmed();
+        if (!kKnownMethods.contains(method)) {
+            *error = QStringLiteral("unknown method in mix: %1").arg(method);
+            return false;
+        }
+        bool ok = true;
+        const int weight = kv.size() > 1 ? kv.at(1).trimmed().toInt(&ok) : 1;
+        if (!ok || weight < 0) {
+            *error = QStringLiteral("invalid weight in mix: %1").arg(part);
+            return false;
+        }
+        if (weight > 0) {
+            mix->append({method, weight});
+        }
+    }
+    if (mix->isEmpty()) {
+        *error = QStringLiteral("mix is empty");
+        return false;
+    }
+    return true;
+}
+
+// nearest-rank 百分位
+double percentileMs(const QVector<qint64> &sorted, double p) {
+    if (sorted.isEmpty()) {
+        return 0.0;
+    }
+    int rank = static_cast<int>(std::ceil(p * sorted.size())) - 1;
+    rank = qBound(0, rank, sorted.size() - 1);
+    return sorted.at(rank) / 1000.0;
+}
+}  // namespace
+
+class LoadClient : public QObject {
+    Q_OBJECT
+
+public:
+    LoadClient(LoadContext *ctx, int index, QObject *parent = nullptr)
+        : QObject(parent), m_ctx(ctx), m_index(index) {
+        connect(&m_socket, &QWebSocket::connected, this, &LoadClient::connected);
+        connect(&m_socket, &QWebSocket::textMessageReceived, this, &LoadClient::onMessage);
+        connect(&m_socket, QOverload<QAbstractSocket::SocketError>::of(&QWebSocket::error), this, [this]() {
+            qWarning() << "connection" << m_index << "error:" << m_socket.errorString();
+            m_failed = true;
+            m_pendingId = -1;
+            emit finished();
+        });
+    }
+
+    void open() { m_socket.open(m_ctx->url); }
+    void start() { sendNext(); }
+    void close() { m_socket.close(); }
+    bool isIdle() const { return m_pendingId < 0; }
+    bool hasFailed() const { return m_failed; }
+
+signals:
+    void connected();
+    void finished();
+
+private:
+    QString pickMethod() {
+        int roll = static_cast<int>(m_ctx->rng.bounded(m_ctx->totalWeight));
+        for (const MethodWeight &mw : qAsConst(m_ctx->mix)) {
+            if (roll < mw.weight) {
+                return mw.method;
+            }
+            roll -= mw.weight;
+        }
+        return m_ctx->mix.constLast().method;
+    }
+
+    void sendNext() {
+        if (m_ctx->stopping || m_failed) {
+            emit finished();
+            return;
+        }
+        m_pendingId = m_nextId++;
+        m_pendingMethod = pickMethod();
+
+        QJsonObject request;
+        request.insert(QStringLiteral("id"), m_pendingId);
+        request.insert(QStringLiteral("method"), m_pendingMethod);
+        request.insert(QStringLiteral("params"), buildParams(*m_ctx, m_pendingMethod, m_index));
+        if (!m_ctx->token.isEmpty()) {
+            request.insert(QStringLiteral("token"), m_ctx->token);
+        }
+        const QString payload = QString::fromUtf8(QJsonDocument(request).toJson(QJsonDocument::Compact));
+        m_timer.start();
+        m_socket.sendTextMessage(payload);
+    }
+
+    void onMessage(const QString &text) {
+        const qint64 latencyUs = m_timer.nsecsElapsed() / 1000;
+        const QJsonObject reply = QJsonDocument::fromJson(text.toUtf8()).object();
+        // 非本连接在途请求的消息（例如 QWebChannel 协议消息）直接忽略
+        if (reply.value(QStringLiteral("id")).toInt(-1) != m_pendingId || m_pendingId < 0) {
+            return;
+        }
+        if (m_ctx->recording) {
+            MethodStats &stats = m_ctx->stats[m_pendingMethod];
+            stats.latenciesUs.append(latencyUs);
+            if (!reply.value(QStringLiteral("error")).isNull()) {
+                ++stats.errors;
+            }
+        }
+        m_pendingId = -1;
+        sendNext();
+    }
+
+    LoadContext *m_ctx = nullptr;
+    int m_index = 0;
+    QWebSocket m_socket;
+    QElapsedTimer m_timer;
+    int m_nextId = 1;
+    int m_pendingId = -1;
+    QString m_pendingMethod;
+    bool m_failed = false;
+};
+
+static void report(const LoadContext &ctx, double seconds, const QString &jsonPath) {
+    QTextStream out(stdout);
+    out << QStringLiteral("%1 %2 %3 %4 %5 %6 %7 %8\n")
+               .arg(QStringLiteral("method"), -16)
+               .arg(QStringLiteral("count"), 8)
+               .arg(QStringLiteral("errors"), 7)
+               .arg(QStringLiteral("req/s"), 10)
+               .arg(QStringLiteral("p50(ms)"), 9)
+               .arg(QStringLiteral("p99(ms)"), 9)
+               .arg(QStringLiteral("p999(ms)"), 9)
+               .arg(QStringLiteral("max(ms)"), 9);
+
+    QJsonArray methods;
+    qint64 totalCount = 0;
+    int totalErrors = 0;
+    QVector<qint64> all;
+    for (const QString &method : kKnownMethods) {
+        if (!ctx.stats.contains(method)) {
+            continue;
+        }
+        const MethodStats &stats = ctx.stats[method];
+        QVector<qint64> sorted = stats.latenciesUs;
+        std::sort(sorted.begin(), sorted.end());
+        all += sorted;
+        totalCount += sorted.size();
+        totalErrors += stats.errors;
+
+        const double rps = seconds > 0 ? sorted.size() / seconds : 0.0;
+        const double maxMs = sorted.isEmpty() ? 0.0 : sorted.constLast() / 1000.0;
+        out << QStringLiteral("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                   .arg(method, -16)
+                   .arg(sorted.size(), 8)
+                   .arg(stats.errors, 7)
+                   .arg(rps, 10, 'f', 1)
+                   .arg(percentileMs(sorted, 0.50), 9, 'f', 2)
+                   .arg(percentileMs(sorted, 0.99), 9, 'f', 2)
+                   .arg(percentileMs(sorted, 0.999), 9, 'f', 2)
+                   .arg(maxMs, 9, 'f', 2);
+
+        QJsonObject line;
+        line.insert(QStringLiteral("method"), method);
+        line.insert(QStringLiteral("count"), sorted.size());
+        line.insert(QStringLiteral("errors"), stats.errors);
+        line.insert(QStringLiteral("rps"), rps);
+        line.insert(QStringLiteral("p50_ms"), percentileMs(sorted, 0.50));
+        line.insert(QStringLiteral("p99_ms"), percentileMs(sorted, 0.99));
+        line.insert(QStringLiteral("p999_ms"), percentileMs(sorted, 0.999));
+        line.insert(QStringLiteral("max_ms"), maxMs);
+        methods.append(line);
+    }
+
+    std::sort(all.begin(), all.end());
+    const double totalRps = seconds > 0 ? totalCount / seconds : 0.0;
+    out << QStringLiteral("%1 %2 %3 %4 %5 %6 %7\n")
+               .arg(QStringLiteral("total"), -16)
+               .arg(totalCount, 8)
+               .arg(totalErrors, 7)
+               .arg(totalRps, 10, 'f', 1)
+               .arg(percentileMs(all, 0.50), 9, 'f', 2)
+               .arg(percentileMs(all, 0.99), 9, 'f', 2)
+               .arg(percentileMs(all, 0.999), 9, 'f', 2);
+    out << QStringLiteral("measured %1 s\n").arg(seconds, 0, 'f', 2);
+    out.flush();
+
+    if (jsonPath.isEmpty()) {
+        return;
+    }
+    QJsonObject doc;
+    doc.insert(QStringLiteral("app"), ctx.app);
+    doc.insert(QStringLiteral("seconds"), seconds);
+    doc.insert(QStringLiteral("total_rps"), totalRps);
+    doc.insert(QStringLiteral("methods"), methods);
+    QFile file(jsonPath);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write(QJsonDocument(doc).toJson());
+    } else {
+        qWarning() << "failed to write json report to" << jsonPath;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("loadgen"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Load generator for UiAutomationProxyServer"));
+    parser.addHelpOption();
+    const QCommandLineOption urlOpt(QStringLiteral("url"), QStringLiteral("Proxy websocket url."),
+                                    QStringLiteral("url"), QStringLiteral("ws://127.0.0.1:12345"));
+    const QCommandLineOption tokenOpt(QStringLiteral("token"), QStringLiteral("Proxy auth token."),
+                                      QStringLiteral("token"), QStringLiteral("demo-token"));
+    const QCommandLineOption connOpt({QStringLiteral("c"), QStringLiteral("connections")},
+                                     QStringLiteral("Concurrent connections."), QStringLiteral("n"), QStringLiteral("8"));
+    const QCommandLineOption durationOpt({QStringLiteral("d"), QStringLiteral("duration")},
+                                         QStringLiteral("Measured seconds."), QStringLiteral("sec"), QStringLiteral("10"));
+    const QCommandLineOption warmupOpt(QStringLiteral("warmup"), QStringLiteral("Warm-up seconds excluded from stats."),
+                                       QStringLiteral("sec"), QStringLiteral("1"));
+    const QCommandLineOption mixOpt(QStringLiteral("mix"),
+                                    QStringLiteral("Weighted method mix, e.g. resolve=40,read_property=30,execute_action=20,dump_tree=5,screenshot=5."),
+                                    QStringLiteral("spec"),
+                                    QStringLiteral("resolve=40,read_property=30,execute_action=20,dump_tree=5,screenshot=5"));
+    const QCommandLineOption appOpt(QStringLiteral("app"), QStringLiteral("Target demo app: qml or widgets."),
+                                    QStringLiteral("app"), QStringLiteral("qml"));
+    const QCommandLineOption shotOpt(QStringLiteral("screenshot-dir"), QStringLiteral("Directory for screenshot requests."),
+                                     QStringLiteral("dir"), QDir::tempPath());
+    const QCommandLineOption seedOpt(QStringLiteral("seed"), QStringLiteral("Random seed for the method mix."),
+                                     QStringLiteral("n"), QStringLiteral("1"));
+    const QCommandLineOption jsonOpt(QStringLiteral("json"), QStringLiteral("Also write the report as json."),
+                                     QStringLiteral("file"));
+    parser.addOptions({urlOpt, tokenOpt, connOpt, durationOpt, warmupOpt, mixOpt, appOpt, shotOpt, seedOpt, jsonOpt});
+    parser.process(app);
+
+    LoadContext ctx;
+    ctx.url = QUrl(parser.value(urlOpt));
+    ctx.token = parser.value(tokenOpt);
+    ctx.app = parser.value(appOpt).trimmed().toLower();
+    ctx.screenshotDir = parser.value(shotOpt);
+    ctx.rng.seed(parser.value(seedOpt).toUInt());
+    if (ctx.app != QStringLiteral("qml") && ctx.app != QStringLiteral("widgets")) {
+        qCritical() << "--app must be qml or widgets";
+        return 2;
+    }
+    QString error;
+    if (!parseMix(parser.value(mixOpt), &ctx.mix, &error)) {
+        qCritical().noquote() << error;
+        return 2;
+    }
+    for (const MethodWeight &mw : qAsConst(ctx.mix)) {
+        ctx.totalWeight += mw.weight;
+    }
+    const int connections = qMax(1, parser.value(connOpt).toInt());
+    const int durationMs = qMax(1, parser.value(durationOpt).toInt()) * 1000;
+    const int warmupMs = qMax(0, parser.value(warmupOpt).toInt()) * 1000;
+    const QString jsonPath = parser.value(jsonOpt);
+
+    QVector<LoadClient *> clients;
+    int connectedCount = 0;
+    int finishedCount = 0;
+    bool done = false;
+    QElapsedTimer measured;
+    double measuredSeconds = 0.0;
+
+    const auto finish = [&]() {
+        if (done) {
+            return;
+        }
+        done = true;
+        for (LoadClient *client : qAsConst(clients)) {
+            client->close();
+        }
+        report(ctx, measuredSeconds, jsonPath);
+        app.quit();
+    };
+
+    const auto stop = [&]() {
+        measuredSeconds = measured.isValid() ? measured.nsecsElapsed() / 1e9 : 0.0;
+        ctx.recording = false;
+        ctx.stopping = true;
+        // 等待在途请求返回，最多再等 5 秒
+        QTimer::singleShot(5000, &app, finish);
+        bool allIdle = true;
+        for (LoadClient *client : qAsConst(clients)) {
+            allIdle = allIdle && client->isIdle();
+        }
+        if (allIdle) {
+            finish();
+        }
+    };
+
+    for (int i = 0; i < connections; ++i) {
+        auto *client = new LoadClient(&ctx, i, &app);
+        clients.append(client);
+        QObject::connect(client, &LoadClient::connected, &app, [&]() {
+            if (++connectedCount != connections) {
+                return;
+            }
+            qInfo().noquote() << QStringLiteral("%1 connections open, warming up %2 ms, measuring %3 ms")
+                                     .arg(connections).arg(warmupMs).arg(durationMs);
+            QTimer::singleShot(warmupMs, &app, [&]() {
+                ctx.recording = true;
+                measured.start();
+            });
+            QTimer::singleShot(warmupMs + durationMs, &app, stop);
+            for (LoadClient *c : qAsConst(clients)) {
+                c->start();
+            }
+        });
+        QObject::connect(client, &LoadClient::finished, &app, [&, client]() {
+            if (client->hasFailed() && !ctx.stopping) {
+                qCritical() << "connection failed before the run finished";
+                app.exit(1);
+                return;
+            }
+            if (ctx.stopping && ++finishedCount == connections) {
+                finish();
+            }
+        });
+        client->open();
+    }
+
+    return app.exec();
+}
+
+#include "main.moc"
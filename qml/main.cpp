@@ -1,11 +1,86 @@
+#include "UiAutomationProxyServer.h"
+
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QDebug>
 #include <QQmlApplicationEngine>
+#include <QQmlContext>
 #include <QUrl>
+#include <QVariantMap>
+
+namespace {
+// 命令行优先，其次环境变量，最后默认值
+QString optionValue(const QCommandLineParser &parser, const QCommandLineOption &option,
+                    const char *envName, const QString &fallback) {
+    if (parser.isSet(option)) {
+        return parser.value(option);
+    }
+    const QByteArray env = qgetenv(envName);
+    return env.isEmpty() ? fallback : QString::fromLocal8Bit(env);
+}
+
+int intOptionValue(const QCommandLineParser &parser, const QCommandLineOption &option,
+                   const char *envName, int fallback) {
+    bool ok = false;
+    const int value = optionValue(parser, option, envName, QString()).toInt(&ok);
+    return ok ? value : fallback;
+}
+}  // namespace
 
 int main(int argc, char *argv[]) {
+    // 平台插件必须在 QApplication 构造前确定，这里先扫描一遍原始参数
+    bool offscreen = !qgetenv("QML_DEMO_OFFSCREEN").isEmpty();
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--offscreen") == 0) {
+            offscreen = true;
+        }
+    }
+    if (offscreen && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication app(argc, argv);
 
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("QML demo and stress fixture"));
+    parser.addHelpOption();
+    const QCommandLineOption offscreenOpt(QStringLiteral("offscreen"),
+                                          QStringLiteral("Run on the offscreen platform (env QML_DEMO_OFFSCREEN)."));
+    const QCommandLineOption sceneOpt(QStringLiteral("scene"),
+                                      QStringLiteral("main | settings | repeaters | listview | mixed (env QML_DEMO_SCENE)."),
+                                      QStringLiteral("name"));
+    const QCommandLineOption copiesOpt(QStringLiteral("copies"),
+                                       QStringLiteral("Settings page copies (env QML_DEMO_COPIES)."), QStringLiteral("n"));
+    const QCommandLineOption depthOpt(QStringLiteral("depth"),
+                                      QStringLiteral("Nested Repeater depth (env QML_DEMO_DEPTH)."), QStringLiteral("n"));
+    const QCommandLineOption breadthOpt(QStringLiteral("breadth"),
+                                        QStringLiteral("Nested Repeater breadth (env QML_DEMO_BREADTH)."), QStringLiteral("n"));
+    const QCommandLineOption rowsOpt(QStringLiteral("rows"),
+                                     QStringLiteral("ListView rows (env QML_DEMO_ROWS)."), QStringLiteral("n"));
+    const QCommandLineOption listCacheOpt(QStringLiteral("list-cache"),
+                                          QStringLiteral("ListView cacheBuffer in pixels (env QML_DEMO_LIST_CACHE)."),
+                                          QStringLiteral("px"));
+    const QCommandLineOption portOpt(QStringLiteral("proxy-port"),
+                                     QStringLiteral("Start UiAutomationProxyServer on this port (env QML_DEMO_PROXY_PORT)."),
+                                     QStringLiteral("port"));
+    const QCommandLineOption tokenOpt(QStringLiteral("proxy-token"),
+                                      QStringLiteral("Proxy auth token (env QML_DEMO_PROXY_TOKEN)."), QStringLiteral("token"));
+    const QCommandLineOption anyOpt(QStringLiteral("proxy-any"),
+                                    QStringLiteral("Listen on all interfaces instead of localhost."));
+    parser.addOptions({offscreenOpt, sceneOpt, copiesOpt, depthOpt, breadthOpt, rowsOpt, listCacheOpt,
+                       portOpt, tokenOpt, anyOpt});
+    parser.process(app);
+
+    const QString scene = optionValue(parser, sceneOpt, "QML_DEMO_SCENE", QStringLiteral("main")).trimmed().toLower();
+    static const QStringList kScenes = {
+        QStringLiteral("main"), QStringLiteral("settings"), QStringLiteral("repeaters"),
+        QStringLiteral("listview"), QStringLiteral("mixed"),
+    };
+    if (!kScenes.contains(scene)) {
+        qCritical() << "Unknown scene" << scene << "expected one of" << kScenes;
+        return 2;
+    }
+
     QQmlApplicationEngine engine;
     QObject::connect(
         &engine,
@@ -17,16 +92,45 @@ int main(int argc, char *argv[]) {
             }
         },
         Qt::QueuedConnection);
-    qInfo() << "Loading QML from qrc:/ui/Main.qml";
-    engine.load(QUrl(QStringLiteral("qrc:/ui/Main.qml")));
-    if (engine.rootObjects().isEmpty()) {
-        qWarning() << "Fallback loading qrc:/Main.qml";
-        engine.load(QUrl(QStringLiteral("qrc:/Main.qml")));
+
+    if (scene == QStringLiteral("main")) {
+        qInfo() << "Loading QML from qrc:/ui/Main.qml";
+        engine.load(QUrl(QStringLiteral("qrc:/ui/Main.qml")));
+        if (engine.rootObjects().isEmpty()) {
+            qWarning() << "Fallback loading qrc:/Main.qml";
+            engine.load(QUrl(QStringLiteral("qrc:/Main.qml")));
+        }
+    } else {
+        QVariantMap config;
+        config.insert(QStringLiteral("scene"), scene);
+        config.insert(QStringLiteral("copies"), qMax(0, intOptionValue(parser, copiesOpt, "QML_DEMO_COPIES", 10)));
+        config.insert(QStringLiteral("depth"), qMax(0, intOptionValue(parser, depthOpt, "QML_DEMO_DEPTH", 4)));
+        config.insert(QStringLiteral("breadth"), qMax(1, intOptionValue(parser, breadthOpt, "QML_DEMO_BREADTH", 3)));
+        config.insert(QStringLiteral("rows"), qMax(0, intOptionValue(parser, rowsOpt, "QML_DEMO_ROWS", 1000)));
+        config.insert(QStringLiteral("listCache"), qMax(0, intOptionValue(parser, listCacheOpt, "QML_DEMO_LIST_CACHE", 320)));
+        engine.rootContext()->setContextProperty(QStringLiteral("stressConfig"), config);
+        qInfo() << "Loading stress scene" << config;
+        engine.load(QUrl(QStringLiteral("qrc:/ui/StressScene.qml")));
     }
     if (engine.rootObjects().isEmpty()) {
         qCritical() << "No root objects loaded for qml_demo";
         return 1;
     }
 
+    // 默认不启动代理：正常使用时代理由 version/ 注入的 DLL 提供，
+    // 仅在压测/基准场景显式指定端口时才在进程内启动。
+    UiAutomationProxyServer proxy;
+    const int port = intOptionValue(parser, portOpt, "QML_DEMO_PROXY_PORT", 0);
+    if (port > 0) {
+        const QString token = optionValue(parser, tokenOpt, "QML_DEMO_PROXY_TOKEN", QStringLiteral("demo-token"));
+        const QHostAddress address = parser.isSet(anyOpt) ? QHostAddress(QHostAddress::Any) : QHostAddress(QHostAddress::LocalHost);
+        proxy.useDefaultQmlHandler(&engine);
+        if (!proxy.start(static_cast<quint16>(port), address, token)) {
+            qCritical() << "Failed to start UiAutomationProxyServer on port" << port;
+            return 1;
+        }
+        qInfo() << "UiAutomationProxyServer listening on" << proxy.serverPort();
+    }
+
     return app.exec();
 }
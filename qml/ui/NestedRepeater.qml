@@ -0,0 +1,42 @@
+import QtQuick 2.15
+import QtQuick.Controls 2.15
+
+// 递归嵌套的 Repeater：每层 breadth 个子节点，共 depth 层，
+// 叶子节点为 Label + Button。节点数约为 breadth^depth，注意控制参数。
+// QML 不允许组件直接实例化自身，因此通过 Loader.setSource 递归。
+Item {
+    id: node
+    objectName: "nested_" + path
+
+    property int depth: 0
+    property int breadth: 2
+    property string path: "0"
+
+    implicitWidth: column.implicitWidth
+    implicitHeight: column.implicitHeight
+
+    Column {
+        id: column
+        spacing: 2
+
+        Label {
+            objectName: "nestedLabel_" + node.path
+            text: "节点 " + node.path
+        }
+        Button {
+            objectName: "nestedButton_" + node.path
+            text: "操作 " + node.path
+            visible: node.depth === 0
+        }
+        Repeater {
+            model: node.depth > 0 ? node.breadth : 0
+            delegate: Loader {
+                Component.onCompleted: setSource("NestedRepeater.qml", {
+                    "depth": node.depth - 1,
+                    "breadth": node.breadth,
+                    "path": node.path + "_" + index
+                })
+            }
+        }
+    }
+}
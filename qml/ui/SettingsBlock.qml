@@ -0,0 +1,85 @@
+import QtQuick 2.15
+import QtQuick.Controls 2.15
+import QtQuick.Layouts 1.3
+
+// Main.qml 中「用户配置 + 权限配置」两页的平铺副本，供压测场景按份复制。
+// 所有 objectName 带 _<blockIndex> 后缀，保证每一份都能被单独定位。
+Item {
+    id: block
+    objectName: "settingsBlock_" + blockIndex
+
+    property int blockIndex: 0
+
+    implicitWidth: layout.implicitWidth
+    implicitHeight: layout.implicitHeight
+
+    ColumnLayout {
+        id: layout
+        anchors.fill: parent
+        spacing: 6
+
+        Label {
+            objectName: "blockTitleLabel_" + block.blockIndex
+            text: "配置 #" + block.blockIndex
+        }
+        TextField {
+            id: nicknameInput
+            objectName: "userNicknameInput_" + block.blockIndex
+            placeholderText: "昵称"
+        }
+        TextField {
+            objectName: "userAvatarPathInput_" + block.blockIndex
+            placeholderText: "上传文件路径"
+        }
+        Slider {
+            objectName: "userVolumeSlider_" + block.blockIndex
+            from: 0
+            to: 100
+            value: 50
+        }
+        ComboBox {
+            id: roleCombo
+            objectName: "permissionRoleCombo_" + block.blockIndex
+            model: ["admin", "editor", "viewer"]
+        }
+        Switch {
+            id: notifyToggle
+            objectName: "notifyToggle_" + block.blockIndex
+            text: "开启通知"
+        }
+        Label {
+            objectName: "toggleStatusLabel_" + block.blockIndex
+            text: "通知: " + (notifyToggle.checked ? "开启" : "关闭")
+        }
+        ButtonGroup { id: modeGroup }
+        RadioButton {
+            objectName: "modeAdminRadio_" + block.blockIndex
+            text: "管理员模式"
+            ButtonGroup.group: modeGroup
+        }
+        RadioButton {
+            objectName: "modeViewerRadio_" + block.blockIndex
+            text: "访客模式"
+            checked: true
+            ButtonGroup.group: modeGroup
+        }
+        CheckBox {
+            objectName: "permReadCheck_" + block.blockIndex
+            text: "读权限"
+        }
+        CheckBox {
+            objectName: "permWriteCheck_" + block.blockIndex
+            text: "写权限"
+        }
+        Button {
+            objectName: "saveBlockButton_" + block.blockIndex
+            text: "保存"
+            onClicked: statusLabel.text = "保存成功: " + nicknameInput.text + " / " + roleCombo.currentText
+        }
+        Label {
+            id: statusLabel
+            objectName: "blockStatusLabel_" + block.blockIndex
+            text: ""
+        }
+    }
+}
@@ -0,0 +1,102 @@
+import QtQuick 2.15
+import QtQuick.Controls 2.15
+import QtQuick.Layouts 1.3
+
+// 压测场景根窗口，由 main.cpp 通过上下文属性 stressConfig 驱动：
+//   scene   "settings" | "repeaters" | "listview" | "mixed"
+//   copies  SettingsBlock 份数
+//   depth / breadth  NestedRepeater 的层数与每层宽度
+//   rows    ListView 行数；listCache 为 cacheBuffer（像素），
+//           调大可让 ListView 一次性实例化更多委托
+ApplicationWindow {
+    id: stressWindow
+    objectName: "qmlStressWindow"
+    width: 1280
+    height: 800
+    visible: true
+    title: "QML Stress Scene"
+
+    readonly property string scene: stressConfig.scene
+    readonly property bool showSettings: scene === "settings" || scene === "mixed"
+    readonly property bool showRepeaters: scene === "repeaters" || scene === "mixed"
+    readonly property bool showList: scene === "listview" || scene === "mixed"
+
+    RowLayout {
+        anchors.fill: parent
+        anchors.margins: 8
+        spacing: 8
+
+        Flickable {
+            objectName: "settingsFlickable"
+            visible: stressWindow.showSettings || stressWindow.showRepeaters
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            contentHeight: content.implicitHeight
+            clip: true
+
+            ColumnLayout {
+                id: content
+                objectName: "stressContent"
+                width: parent.width
+
+                Repeater {
+                    objectName: "settingsRepeater"
+                    model: stressWindow.showSettings ? stressConfig.copies : 0
+                    delegate: SettingsBlock {
+                        blockIndex: index
+                        Layout.fillWidth: true
+                    }
+                }
+
+                Loader {
+                    objectName: "nestedLoader"
+                    active: stressWindow.showRepeaters
+                    sourceComponent: NestedRepeater {
+                        depth: stressConfig.depth
+                        breadth: stressConfig.breadth
+                    }
+                }
+            }
+        }
+
+        ListView {
+            id: stressList
+            objectName: "stressListView"
+            visible: stressWindow.showList
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            clip: true
+            cacheBuffer: stressConfig.listCache
+            model: stressWindow.showList ? stressConfig.rows : 0
+            delegate: Rectangle {
+                objectName: "listRow_" + index
+                width: stressList.width
+                height: 40
+                color: index % 2 ? "#f4f4f4" : "#ffffff"
+
+                RowLayout {
+                    anchors.fill: parent
+                    anchors.leftMargin: 8
+                    anchors.rightMargin: 8
+
+                    CheckBox {
+                        objectName: "listRowCheck_" + index
+                    }
+                    Label {
+                        objectName: "listRowLabel_" + index
+                        text: "第 " + index + " 行"
+                        Layout.fillWidth: true
+                    }
+                    TextField {
+                        objectName: "listRowInput_" + index
+                        placeholderText: "备注 " + index
+                    }
+                    Button {
+                        objectName: "listRowButton_" + index
+                        text: "打开"
+                    }
+                }
+            }
+        }
+    }
+}
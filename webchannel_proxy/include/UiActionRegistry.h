@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QFlags>
+#include <QHash>
+#include <QJsonValue>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+class QObject;
+
+// ════════════════════════════════════════════════════════════════
+//  UiActionRegistry — execute_action 的动作表
+//
+//  动作 id → 处理函数，替代 executeAction 里逐个比较字符串的分支链：
+//  id 注册与查找时统一 trim + 小写，查找是一次哈希。
+//  内置处理器在构造时登记 click / input / select 等内置动作，
+//  应用可为自己的组件登记编译期动作（多步操作在进程内一次完成，
+//  不必拆成多次 RPC），同名登记覆盖已有动作（包括内置动作）。
+//
+//  处理函数收到已解析的目标对象与 value 参数；写入 *error 表示失败，
+//  返回值作为 execute_action 的 result。
+// ════════════════════════════════════════════════════════════════
+class UiActionRegistry {
+public:
+    using Handler = std::function<QJsonValue(QObject *target, const QJsonValue &value, QString *error)>;
+
+    enum Flag {
+        NoFlags        = 0x0,
+        RootIfNoTarget = 0x1,  // target 为空时作用于根对象（如 close_page）
+        NoSettle       = 0x2,  // 执行后不调用 processEvents()
+    };
+    Q_DECLARE_FLAGS(Flags, Flag)
+
+    struct Action {
+        Handler handler;
+        Flags   flags;
+    };
+
+    void add(const QString &id, Handler handler, Flags flags = NoFlags);
+    bool remove(const QString &id);
+    const Action *find(const QString &id) const;
+    QStringList ids() const { return m_actions.keys(); }
+
+    static QString normalize(const QString &id) { return id.trimmed().toLower(); }
+
+private:
+    QHash<QString, Action> m_actions;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(UiActionRegistry::Flags)
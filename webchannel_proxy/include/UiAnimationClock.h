@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QAnimationDriver>
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QJsonObject>
+
+// ════════════════════════════════════════════════════════════════
+//  UiAnimationClock — 可调速 / 可手动步进的动画时钟
+//
+//  以自定义 QAnimationDriver 安装到 GUI 线程，接管 QUnifiedTimer 的时间源：
+//    · 调速：动画时间 = 实际时间 × speed（如 10 倍速）
+//    · 手动：不再随实际时间推进，只在 step() 时按帧长逐帧前进，
+//      每帧之间处理一次事件，状态切换触发的后续动画照常衔接
+//  动画仍逐帧求值，终态与正常速度一致；speed 很大时过渡几乎立即完成。
+//
+//  QUnifiedTimer 同时只接受一个驱动：线程化 / windows 渲染循环在创建
+//  窗口时已装上自己的驱动，此时 install() 只打印警告，isInstalled()
+//  为 false，时钟不起作用。因此需要 basic 渲染循环
+//  （QSG_RENDER_LOOP=basic），或在创建第一个 QQuickWindow 之前构造。
+//  装不上时只能经 QUnifiedTimer 的 speedModifier 调速（setTimerSpeed），
+//  手动步进不可用。
+//  生效后 speed 为 1 即按实际时间推进（不与 vsync 对齐）；析构时卸载，
+//  恢复 Qt 的默认驱动。在渲染线程执行的 Animator 不受影响。
+// ════════════════════════════════════════════════════════════════
+class UiAnimationClock : public QAnimationDriver {
+    Q_OBJECT
+
+public:
+    explicit UiAnimationClock(QObject* parent = nullptr);
+    ~UiAnimationClock() override;
+
+    void setSpeed(qreal speed);
+    qreal speed() const { return speed_; }
+    void setManual(bool manual);
+    bool isManual() const { return manual_; }
+
+    // 手动模式下把动画时间推进 ms，每帧 frameMs
+    void step(int ms, int frameMs = kFrameMs);
+
+    // 自驱动启动以来的动画时间（毫秒）
+    qint64 elapsed() const override;
+
+    // {speed, manual, elapsedMs}
+    QJsonObject state() const;
+
+    // 不替换驱动的调速：QUnifiedTimer 的 speedModifier，作用于当前驱动
+    static void  setTimerSpeed(qreal speed);
+    static qreal timerSpeed();
+
+    static const int kFrameMs = 16;
+
+protected:
+    void start() override;
+    void stop() override;
+    void timerEvent(QTimerEvent* event) override;
+
+private:
+    // 把已流逝的实际时间折算进 base_，之后再改 speed / 模式
+    void rebase();
+    void updateTimer();
+
+    QElapsedTimer real_;
+    qint64        realMark_ = 0;  // base_ 对应的实际时间点
+    qint64        base_ = 0;      // realMark_ 时的动画时间
+    qreal         speed_ = 1.0;
+    bool          manual_ = false;
+    QBasicTimer   timer_;
+};
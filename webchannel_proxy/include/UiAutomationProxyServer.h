@@ -1,11 +1,17 @@
 #pragma once
 
 #include <QObject>
+#include <QFuture>
 #include <QHostAddress>
 #include <QHash>
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonValue>
+#include <QSet>
+#include <QStringList>
 #include <QVariant>
+#include <QVector>
+#include <functional>
 #include <memory>
 
 class QWebSocket;
@@ -13,6 +19,16 @@ class QWebSocketServer;
 class QWebChannel;
 class QWebChannelAbstractTransport;
 class QQmlApplicationEngine;
+class QmlQuerySelector;
+class UiLiveQueryRegistry;
+class UiSceneSnapshot;
+class UiTextIndex;
+class UiPropertyReader;
+class UiTypeSchema;
+class UiActionRegistry;
+class UiSettleMonitor;
+class UiAnimationClock;
+class UiRenderThrottle;
 
 class UiAutomationHandler {
 public:
@@ -22,11 +38,74 @@ public:
     virtual QJsonValue readProperty(const QJsonObject &target, const QString &propertyName, QString *error) = 0;
     virtual QJsonValue screenshot(const QString &path, QString *error) = 0;
     virtual QJsonValue dumpTree(QString *error) = 0;
+    // 字段投影：只读取并返回 fields 列出的字段（objectName / className / 属性名），
+    // fields 为空时同不带投影的版本。默认实现取完整结果后删去未列出的字段，
+    // 内置处理器只求值列出的属性
+    virtual QJsonValue resolve(const QJsonObject &target, const QStringList &fields, QString *error);
+    virtual QJsonValue dumpTree(const QStringList &fields, QString *error);
+    // 批量解析：返回与 targets 等长的数组，每项为 {ok, result} 或 {ok: false, error}。
+    // 默认逐个调用 resolve()；内置处理器把无超时的 selector 目标合并为一次树遍历。
+    virtual QJsonValue resolveMany(const QJsonArray &targets, QString *error);
+    // selector 目标的全部命中（文档顺序）：跳过前 offset 个，最多返回 limit 个（<= 0 不限）。
+    // 返回 {count, items}；countOnly 时只返回 {count}，不构建结果列表。
+    virtual QJsonValue queryAll(const QJsonObject &target, int offset, int limit, bool countOnly, QString *error);
+    // 批量读属性：targets 逐项解析（同 resolve_many），selector 非空时改为其全部命中。
+    // 返回紧凑表 {columns, rows[, errors]}：未找到的目标对应 null 行，
+    // errors 为 [{index, error}]
+    virtual QJsonValue readProperties(const QJsonArray &targets, const QJsonObject &selector,
+                                      const QStringList &properties, QString *error);
+    // 类型描述（属性 / 方法元数据）：target 非空时取其元对象，否则按 className 查找
+    virtual QJsonValue describeType(const QJsonObject &target, const QString &className, QString *error);
+    // 批量更新：updates 为 [{target, property, value}]（或以 action 代替 property，
+    // 走动作表但不逐个 settle）。全部应用完之后才处理一次事件，布局 / polish / 渲染
+    // 只跑一轮。返回 {applied, failed: [{index, error}]}
+    virtual QJsonValue apply(const QJsonArray &updates, QString *error);
+    // 等待界面静止（无运行中的动画、无加载中的 Loader、quietMs 内无帧交换），
+    // options 为 {quietMs, timeoutMs}。返回 {idle, elapsedMs, frames[, pending]}，
+    // 超时不算错误
+    virtual QJsonValue waitIdle(const QJsonObject &options, QString *error);
+    // 吞吐模式：options 为 {mode: "normal" | "throttle" | "suspend", intervalMs}，
+    // 挂起或按间隔合并窗口渲染（见 UiRenderThrottle）。返回 {mode, intervalMs, windows, suppressed}
+    virtual QJsonValue setRenderMode(const QJsonObject &options, QString *error);
+    // execute_action 的动作表；应用可在其中登记自定义动作。默认没有（不支持登记）
+    virtual UiActionRegistry *actionRegistry() { return nullptr; }
+    // 选择器查询的根对象（活动查询在这些根下注册），默认没有
+    virtual QList<QObject *> searchRoots() const { return {}; }
+    // "text" / "title" 目标比较的属性（快照查询与实时查找一致），默认没有
+    virtual QStringList textProperties() const { return {}; }
+    // 选择器结果缓存的命中统计 {hits, misses, bypassed, hitRate, size, capacity}
+    virtual QJsonValue selectorCacheStats(QString *error);
+    // 在 GUI 线程上把搜索根采集为只读快照（properties 为需要保存的属性），
+    // 供工作线程查询；不支持时返回空指针并写入 *error
+    virtual std::shared_ptr<const UiSceneSnapshot> captureSnapshot(const QSet<QString> &properties, QString *error);
+
+protected:
+    static QJsonObject resolveManyEntry(const QJsonValue &result, const QString &error);
+    static QJsonObject selectorCacheStatsJson(const QmlQuerySelector &selector);
+    // read_properties 的结果表：每个对象一行，未解析到对象的行连同 errors 中的原因列入 "errors"
+    static QJsonObject propertyTable(UiPropertyReader &reader, const QVector<QObject *> &objects,
+                                     const QVector<QString> &errors, const QStringList &properties);
+    // describe_type：有 obj 时描述其类型，否则在 roots 下按 className 解析
+    static QJsonValue describeTypeOf(UiTypeSchema &schema, QObject *obj, const QString &className,
+                                     const QList<QObject *> &roots, QString *error);
+    // apply 的单项：有 action 时调用动作表，否则经 write 写属性；失败写入 *error
+    static void applyOne(UiActionRegistry &actions, QObject *obj, const QJsonObject &update,
+                         const std::function<bool(QObject *, const QString &, const QVariant &)> &write, QString *error);
+    // render_mode：解析 options 并切换 roots 下窗口的节流模式，返回节流状态
+    static QJsonValue renderModeOf(UiRenderThrottle &throttle, const QList<QObject *> &roots,
+                                   const QJsonObject &options, QString *error);
+    // "text" / "title" 目标：经文本索引查找 roots 下首个命中。
+    // target 可选 "match": "exact"（默认）| "contains"，"caseSensitive"（默认 true）
+    static QObject *findTextTarget(UiTextIndex &index, const QList<QObject *> &roots, const QJsonObject &target,
+                                   const QString &value);
+    // 内置处理器的选择器结果缓存容量（条目数）
+    static const int kSelectorCacheCapacity = 256;
 };
 
 class QtGenericUiAutomationHandler final : public UiAutomationHandler {
 public:
     explicit QtGenericUiAutomationHandler(QObject *rootObject = nullptr);
+    ~QtGenericUiAutomationHandler() override;
 
     void setRootObject(QObject *rootObject);
     QObject *rootObject() const;
@@ -36,23 +115,51 @@ public:
     QJsonValue readProperty(const QJsonObject &target, const QString &propertyName, QString *error) override;
     QJsonValue screenshot(const QString &path, QString *error) override;
     QJsonValue dumpTree(QString *error) override;
+    QJsonValue resolve(const QJsonObject &target, const QStringList &fields, QString *error) override;
+    QJsonValue dumpTree(const QStringList &fields, QString *error) override;
+    QJsonValue resolveMany(const QJsonArray &targets, QString *error) override;
+    QJsonValue queryAll(const QJsonObject &target, int offset, int limit, bool countOnly, QString *error) override;
+    QJsonValue readProperties(const QJsonArray &targets, const QJsonObject &selector, const QStringList &properties,
+                              QString *error) override;
+    QJsonValue describeType(const QJsonObject &target, const QString &className, QString *error) override;
+    QJsonValue apply(const QJsonArray &updates, QString *error) override;
+    QJsonValue waitIdle(const QJsonObject &options, QString *error) override;
+    QJsonValue setRenderMode(const QJsonObject &options, QString *error) override;
+    UiActionRegistry *actionRegistry() override;
+    QList<QObject *> searchRoots() const override;
+    QStringList textProperties() const override;
+    QJsonValue selectorCacheStats(QString *error) override;
+    std::shared_ptr<const UiSceneSnapshot> captureSnapshot(const QSet<QString> &properties, QString *error) override;
 
 private:
+    void registerBuiltinActions();
     QObject *findTarget(const QJsonObject &target, QString *error) const;
+    QVector<QObject *> findTargets(QObject *root, const QJsonArray &targets, QVector<QString> *errors) const;
     bool clickObject(QObject *obj) const;
     bool setChecked(QObject *obj, bool checked) const;
     bool setCurrentText(QObject *obj, const QString &value) const;
     bool setCurrentIndex(QObject *obj, int index) const;
     bool closeObject(QObject *obj) const;
     bool setTextValue(QObject *obj, const QString &value) const;
+    bool writeProperty(QObject *obj, const QString &property, const QVariant &value) const;
     QObject *rootRequired(QString *error) const;
 
     QObject *m_root = nullptr;
+    // 跨调用复用，保留选择器解析缓存
+    std::unique_ptr<QmlQuerySelector> m_selector;
+    // text / title / windowTitle 索引
+    std::unique_ptr<UiTextIndex> m_textIndex;
+    std::unique_ptr<UiPropertyReader> m_propertyReader;
+    std::unique_ptr<UiTypeSchema> m_typeSchema;
+    std::unique_ptr<UiActionRegistry> m_actions;
+    std::unique_ptr<UiSettleMonitor> m_settle;
+    std::unique_ptr<UiRenderThrottle> m_render;
 };
 
 class QtQmlUiAutomationHandler final : public UiAutomationHandler {
 public:
     explicit QtQmlUiAutomationHandler(QQmlApplicationEngine *engine = nullptr);
+    ~QtQmlUiAutomationHandler() override;
 
     void setEngine(QQmlApplicationEngine *engine);
     QQmlApplicationEngine *engine() const;
@@ -62,10 +169,27 @@ public:
     QJsonValue readProperty(const QJsonObject &target, const QString &propertyName, QString *error) override;
     QJsonValue screenshot(const QString &path, QString *error) override;
     QJsonValue dumpTree(QString *error) override;
+    QJsonValue resolve(const QJsonObject &target, const QStringList &fields, QString *error) override;
+    QJsonValue dumpTree(const QStringList &fields, QString *error) override;
+    QJsonValue resolveMany(const QJsonArray &targets, QString *error) override;
+    QJsonValue queryAll(const QJsonObject &target, int offset, int limit, bool countOnly, QString *error) override;
+    QJsonValue readProperties(const QJsonArray &targets, const QJsonObject &selector, const QStringList &properties,
+                              QString *error) override;
+    QJsonValue describeType(const QJsonObject &target, const QString &className, QString *error) override;
+    QJsonValue apply(const QJsonArray &updates, QString *error) override;
+    QJsonValue waitIdle(const QJsonObject &options, QString *error) override;
+    QJsonValue setRenderMode(const QJsonObject &options, QString *error) override;
+    UiActionRegistry *actionRegistry() override;
+    QList<QObject *> searchRoots() const override;
+    QStringList textProperties() const override;
+    QJsonValue selectorCacheStats(QString *error) override;
+    std::shared_ptr<const UiSceneSnapshot> captureSnapshot(const QSet<QString> &properties, QString *error) override;
 
 private:
+    void registerBuiltinActions();
     QObject *findTarget(const QJsonObject &target, QString *error) const;
     QObject *findTargetOnce(const QJsonObject &target, QString *error) const;
+    QVector<QObject *> findTargets(const QList<QObject *> &roots, const QJsonArray &targets, QVector<QString> *errors) const;
     bool clickObject(QObject *obj, const QString &methodName = QString(), QString *error = nullptr, const QVariantList &args = QVariantList()) const;
     bool closeObject(QObject *obj) const;
     bool setPropertyValue(QObject *obj, const QString &property, const QVariant &value) const;
@@ -73,6 +197,14 @@ private:
     QObject *getRoot() const;
 
     QQmlApplicationEngine *m_engine = nullptr;
+    std::unique_ptr<QmlQuerySelector> m_selector;
+    // text / title / placeholderText 索引
+    std::unique_ptr<UiTextIndex> m_textIndex;
+    std::unique_ptr<UiPropertyReader> m_propertyReader;
+    std::unique_ptr<UiTypeSchema> m_typeSchema;
+    std::unique_ptr<UiActionRegistry> m_actions;
+    std::unique_ptr<UiSettleMonitor> m_settle;
+    std::unique_ptr<UiRenderThrottle> m_render;
 };
 
 class UiAutomationBridge : public QObject {
@@ -83,16 +215,52 @@ public:
     void setHandler(UiAutomationHandler *handler);
     UiAutomationHandler *handler() const;
 
-    Q_INVOKABLE QJsonObject resolve(const QJsonObject &target) const;
-    Q_INVOKABLE QJsonObject executeAction(const QString &action, const QJsonObject &target, const QJsonValue &value) const;
+    Q_INVOKABLE QJsonObject resolve(const QJsonObject &target, const QStringList &fields = QStringList()) const;
+    // settle 为 true 或 {quietMs, timeoutMs} 时，动作成功后等待界面静止，
+    // 等待结果附在回复的 "settle" 字段
+    Q_INVOKABLE QJsonObject executeAction(const QString &action, const QJsonObject &target, const QJsonValue &value,
+                                          const QJsonValue &settle = QJsonValue()) const;
     Q_INVOKABLE QJsonObject readProperty(const QJsonObject &target, const QString &propertyName) const;
+    Q_INVOKABLE QJsonObject readProperties(const QJsonArray &targets, const QJsonObject &target,
+                                           const QStringList &properties) const;
     Q_INVOKABLE QJsonObject screenshot(const QString &path) const;
-    Q_INVOKABLE QJsonObject dumpTree() const;
+    Q_INVOKABLE QJsonObject dumpTree(const QStringList &fields = QStringList()) const;
+    Q_INVOKABLE QJsonObject resolveMany(const QJsonArray &targets) const;
+    Q_INVOKABLE QJsonObject queryAll(const QJsonObject &target, int offset, int limit, bool countOnly) const;
+    Q_INVOKABLE QJsonObject selectorCacheStats() const;
+    Q_INVOKABLE QJsonObject describeType(const QJsonObject &target, const QString &className) const;
+    Q_INVOKABLE QJsonObject apply(const QJsonArray &updates, const QJsonValue &settle = QJsonValue()) const;
+    Q_INVOKABLE QJsonObject waitIdle(const QJsonObject &options = QJsonObject()) const;
+    Q_INVOKABLE QJsonObject setRenderMode(const QJsonObject &options) const;
+    // 动画时钟：options 为 {speed, manual}，缺省项保持当前值。首次调用时安装
+    // 自定义动画驱动（见 UiAnimationClock），此后一直生效；返回 {speed, manual, elapsedMs, driver: "clock"}。
+    // 渲染循环已装有自己的驱动时改用 QUnifiedTimer 的 speedModifier 调速，
+    // 返回 {speed, manual: false, driver: "speedModifier"}；此时 manual 为 true 的调用失败
+    Q_INVOKABLE QJsonObject setAnimationClock(const QJsonObject &options);
+    // 手动模式下把动画推进 ms 毫秒（每帧 frameMs）；未处于手动模式时先切换过去。
+    // 需要自定义动画驱动，安装不上时失败
+    Q_INVOKABLE QJsonObject stepAnimations(int ms, int frameMs);
+    // 快照一致性的 query_all：GUI 线程只做一次采集，匹配在线程池中执行，
+    // 结果为采集时刻的状态。target 为 selector 或 text / title（文本搜索）；
+    // parallel 时按节点区间分块并行匹配。future 的结果格式同其他调用的 {ok, result|error}
+    QFuture<QJsonObject> queryAllSnapshot(const QJsonObject &target, int offset, int limit, bool countOnly,
+                                          bool parallel) const;
+
+    // 活动查询不在 webchannel 上公开：差量只推送给注册它的 websocket 连接，
+    // 服务端记录所属连接并在断开时清理
+    QJsonObject addLiveQuery(const QString &selector);
+    QJsonObject removeLiveQuery(int id);
+    UiLiveQueryRegistry *liveQueries() const { return m_liveQueries; }
 
 private:
     QJsonObject ok(const QJsonValue &result) const;
     QJsonObject fail(const QString &error) const;
+    QJsonObject settled(QJsonObject reply, const QJsonValue &settle) const;
+    // 按需创建并安装动画时钟；未能成为当前驱动时销毁并返回 false
+    bool ensureAnimationClock(QString *error);
     UiAutomationHandler *m_handler = nullptr;
+    UiLiveQueryRegistry *m_liveQueries = nullptr;
+    UiAnimationClock *m_animationClock = nullptr;
 };
 
 class UiAutomationProxyServer : public QObject {
@@ -105,6 +273,8 @@ public:
     void useDefaultQtHandler(QObject *rootObject);
     void useDefaultQmlHandler(QQmlApplicationEngine *engine);
     UiAutomationBridge *bridge() const;
+    // 当前处理器的动作表（登记自定义动作用）；处理器不支持时为 nullptr
+    UiActionRegistry *actionRegistry() const;
 
     bool start(quint16 port, const QHostAddress &address = QHostAddress::LocalHost, const QString &token = QString());
     void stop();
@@ -117,6 +287,9 @@ private:
     void onSocketDisconnected(QWebSocket *socket);
     void onSocketMessage(QWebSocket *socket, const QString &textMessage);
     void reply(QWebSocket *socket, int id, const QJsonValue &result, const QString &error = QString()) const;
+    void onLiveQueryDelta(int id, const QJsonArray &entered, const QJsonArray &left);
+    // 异步调用完成后回复；连接已断开时丢弃
+    void replyLater(QWebSocket *socket, int id, const QFuture<QJsonObject> &future);
 
     QString m_token;
     QWebSocketServer *m_server = nullptr;
@@ -124,4 +297,6 @@ private:
     UiAutomationBridge *m_bridge = nullptr;
     std::unique_ptr<UiAutomationHandler> m_defaultHandler;
     QHash<QWebSocket *, SocketTransport *> m_transports;
+    // 活动查询 id → 注册它的连接，差量只推给注册方
+    QHash<int, QWebSocket *> m_liveQueryOwners;
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "UiQMLQuery.h"
+#include "UiTreeWatcher.h"
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+// ════════════════════════════════════════════════════════════════
+//  UiLiveQueryRegistry — 活动查询
+//
+//  客户端注册一个选择器后，服务端持有它的命中集合，并随界面变化
+//  增量维护，只推送进入 / 离开的差量（delta 信号）：
+//    · UiTreeWatcher 监听注册根下的结构变化，以及选择器依赖的属性
+//      （属性条件 + 状态伪类）的 notify 信号
+//    · 变化按事件循环合并为若干 scope，只对落在 scope 内的部分重新查询，
+//      与旧命中中位于该 scope 的部分求差
+//    · 含 :has 的选择器中后代变化会影响祖先，退化为整根重新查询
+//    · 命中对象销毁时立即推送离开
+//
+//  节点以 ref（注册表内递增的整数）标识，进入时附带 objectName / className，
+//  离开时复用进入时的描述，对象已销毁也能给出。
+// ════════════════════════════════════════════════════════════════
+class UiLiveQueryRegistry : public QObject {
+    Q_OBJECT
+
+public:
+    explicit UiLiveQueryRegistry(QObject* parent = nullptr);
+    ~UiLiveQueryRegistry() override;
+
+    // 注册活动查询，返回 id（失败返回 -1 并写入 *error）；
+    // *initial 写入当前的全部命中（文档顺序）
+    int  add(const QList<QObject*>& roots, const QString& selector,
+             QJsonArray* initial, QString* error = nullptr);
+    bool remove(int id);
+    int  count() const { return queries_.size(); }
+
+signals:
+    void delta(int id, const QJsonArray& entered, const QJsonArray& left);
+
+private:
+    struct LiveQuery {
+        QString                   selector;
+        QList<QPointer<QObject>>  roots;
+        bool                      relative = false;
+        QHash<QObject*, QJsonObject> members;  // 命中 → 进入时的描述
+    };
+
+    void onTreeChanged(const QList<QObject*>& scopes);
+    void onMemberDestroyed(QObject* obj);
+    // 在 scopes 内重新查询 query，返回差量
+    void refresh(LiveQuery& query, const QList<QObject*>& scopes,
+                 QJsonArray* entered, QJsonArray* left);
+    QJsonObject describe(QObject* obj);
+    void enter(LiveQuery& query, QObject* obj, QJsonArray* entered);
+
+    UiTreeWatcher             watcher_;
+    QmlQuerySelector          selector_;
+    QHash<int, LiveQuery>     queries_;
+    QHash<QObject*, int>      refs_;
+    int                       nextId_  = 1;
+    int                       nextRef_ = 1;
+};
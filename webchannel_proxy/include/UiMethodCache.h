@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QByteArray>
+#include <QMetaMethod>
+
+// ════════════════════════════════════════════════════════════════
+//  UiMethodCache — 按 (类名, 方法名 / 签名) 缓存的方法解析
+//
+//  动作路径（click / toggle / setChecked / 自定义 QML 信号等）原先每次
+//  按名 QMetaObject::invokeMethod 或遍历全部方法；解析结果现按类名缓存，
+//  调用方拿到 QMetaMethod 后直接 QMetaMethod::invoke()。
+//  未找到也会缓存（回退链里逐个尝试的名字不再重复扫描）。
+//
+//  QML 对象的元对象按实例分配，故不以其地址为键。缓存项记录
+//  methodCount 与所解析方法的签名，命中时与当前元对象核对，
+//  不一致即重新解析；条目数超过上限时整体清空。
+//  仅限 GUI 线程使用。
+// ════════════════════════════════════════════════════════════════
+namespace UiMethodCache {
+
+// 规范化签名（如 "setChecked(bool)"）对应的方法；不存在时返回无效 QMetaMethod
+QMetaMethod bySignature(const QMetaObject* mo, const QByteArray& signature);
+
+// 按名查找可调用的 slot / method / signal：优先无参，
+// 其次单参且参数为 QVariant / bool / int / QString 的重载
+QMetaMethod byName(const QMetaObject* mo, const QByteArray& name);
+
+// 已缓存的条目数
+int size();
+
+}  // namespace UiMethodCache
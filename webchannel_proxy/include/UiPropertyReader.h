@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+class QObject;
+struct QMetaObject;
+
+// ════════════════════════════════════════════════════════════════
+//  UiPropertyReader — 多对象 × 多属性的批量读取
+//
+//  read_properties 使用：结果为紧凑表
+//    {columns: [属性名...], rows: [[值...], ...]}
+//  行与 objects 一一对应，objects 中的 nullptr 对应 null 行。
+//
+//  列集合 → (类名 → 各列的 QMetaProperty 下标) 两级缓存：
+//  同一类型的对象只在首次出现时按名查找属性，之后每个对象
+//  只做一次类名的哈希查找，再按下标 QMetaProperty::read()。
+//  元对象上不存在的列（动态属性、QML 附加属性）按
+//  SelectorDetail::readProperty 的三级回退逐个读取。
+//
+//  按类名而不是元对象指针做键：声明了成员的 QML 对象各有一份
+//  随对象释放的元对象，指针既不稳定也会被复用，且会让缓存随实例增长。
+//  命中时核对 propertyCount 与各下标处的属性名，不一致时重新解析。
+//  列集合由客户端给出，种类不受控：超过 kMaxColumnSets 时整体清空。
+//
+//  resolve / dump_tree 的字段投影（project）共用同一缓存：
+//  只读取、序列化投影列出的字段，未列出的属性（可能是代价高的
+//  QML 绑定）不会被求值。className 为内建字段，取元对象类名。
+// ════════════════════════════════════════════════════════════════
+class UiPropertyReader {
+public:
+    QJsonObject readTable(const QVector<QObject*>& objects, const QStringList& properties);
+    // 按 fields 投影为 {字段: 值}；无效值省略
+    QJsonObject project(QObject* obj, const QStringList& fields);
+    QJsonArray  project(const QList<QObject*>& objects, const QStringList& fields);
+
+    int  cachedTypes() const;
+    void clear() { layouts_.clear(); }
+
+private:
+    struct Layout {
+        int               propertyCount = -1;
+        QVector<int>      indices;   // 与列对齐；kFallback 走回退读取，kClassName 取类名
+        QVector<QByteArray> names;   // 与列对齐的属性名，命中时核对
+    };
+    using LayoutTable = QHash<QByteArray, Layout>;   // 类名 → 下标
+
+    static const int kFallback  = -1;
+    static const int kClassName = -2;
+    static const int kMaxColumnSets = 64;
+
+    // 列集合对应的下标表，必要时先清空缓存
+    LayoutTable& tableFor(const QStringList& columns);
+
+    static const Layout& layout(LayoutTable& table, const QMetaObject* mo, const QStringList& properties);
+    static bool matches(const Layout& entry, const QMetaObject* mo);
+    static QVariant read(QObject* obj, const QMetaObject* mo, int index, const QString& name);
+    static QJsonObject projectOne(QObject* obj, LayoutTable& table, const QStringList& fields);
+
+    QHash<QString, LayoutTable> layouts_;   // 列集合（逗号拼接）→ 按类型的下标
+};
@@ -1,105 +1,22 @@
 #pragma once
 
+#include "UiSelectorEngine.h"
+
+#include <QCache>
 #include <QObject>
+#include <QPointer>
+#include <QSet>
 #include <QString>
-#include <QVariant>
+#include <QStringList>
 #include <QList>
-#include <QHash>
-#include <QSet>
-#include <stdexcept>
-#include <bitset>
-#include <QMutex>
-#include <QMutexLocker>
-#include <QFile>
-#include <QTextStream>
-#include <QDateTime>
 
-// ════════════════════════════════════════════════════════════════
-//  解析错误异常
-//  parseToken() 遇到语法错误时抛出，携带位置和原因信息。
-// ════════════════════════════════════════════════════════════════
-class SelectorParseError : public std::runtime_error {
-public:
-    explicit SelectorParseError(const QString& msg)
-        : std::runtime_error(msg.toStdString()) {}
-};
+#include <memory>
 
-// ════════════════════════════════════════════════════════════════
-//  1. 属性条件
-// ════════════════════════════════════════════════════════════════
-struct AttributeCondition {
-    QString name;   // 属性名，e.g. "placeholderText"
-    QString op;     // "=" | "~=" | "^=" | "$=" | "*=" | "|=" | ""(仅存在性)
-    QString value;  // 期望值
-};
+class UiTreeWatcher;
+class UiSceneSnapshot;
 
 // ════════════════════════════════════════════════════════════════
-//  2. 伪类
-// ════════════════════════════════════════════════════════════════
-struct PseudoClass {
-    enum Type {
-        NthChild,       // :nth-child(n)
-        NthLastChild    // :nth-last-child(n)
-    };
-    Type type;
-    int  n;     // 位置参数（1-based）
-};
-
-// ════════════════════════════════════════════════════════════════
-//  3. 选择器 Token
-// ════════════════════════════════════════════════════════════════
-struct SelectorToken {
-    QString                   typeName;    // QML 类型名；空 = 通配符 *
-    QList<AttributeCondition> attributes;
-    QList<PseudoClass>        pseudos;
-};
-
-// ════════════════════════════════════════════════════════════════
-//  4. 组合器类型
-// ════════════════════════════════════════════════════════════════
-enum class Combinator {
-    Descendant, // ' '  后代
-    Child,      // '>'  直接子
-    Adjacent,   // '+'  紧邻前兄弟
-    Sibling     // '~'  任意前兄弟
-};
-
-// ════════════════════════════════════════════════════════════════
-//  5. 选择器段
-// ════════════════════════════════════════════════════════════════
-struct SelectorSegment {
-    SelectorToken token;
-    Combinator    combinator;
-};
-
-using SelectorChain = QList<SelectorSegment>;
-
-// ════════════════════════════════════════════════════════════════
-//  6. 布隆过滤器
-// ════════════════════════════════════════════════════════════════
-class BloomFilter {
-    static constexpr int BITS = 1024;
-    std::bitset<BITS> bits_;
-
-    int hash1(const QString& s) const {
-        uint h = 5381;
-        for (QChar c : s) h = ((h << 5) + h) ^ c.unicode();
-        return static_cast<int>(h % BITS);
-    }
-    int hash2(const QString& s) const {
-        uint h = 0;
-        for (QChar c : s) h = h * 31 + c.unicode();
-        return static_cast<int>((h ^ (h >> 16)) % BITS);
-    }
-
-public:
-    void add(const QString& s)             { bits_.set(hash1(s)); bits_.set(hash2(s)); }
-    bool mayContain(const QString& s) const{ return bits_.test(hash1(s)) && bits_.test(hash2(s)); }
-    void merge(const BloomFilter& o)       { bits_ |= o.bits_; }
-};
-
-// ════════════════════════════════════════════════════════════════
-//  7. 主引擎类
+//  7. 查询入口
 //
 //  支持的选择器规则：
 //    [attr]           属性存在性
@@ -114,17 +31,60 @@ public:
 //    A > B            直接子
 //    A + B            紧邻前兄弟
 //    A ~ B            任意前兄弟
-//    :nth-child(n)    父元素第 n 个子元素（1-based）
-//    :nth-last-child(n) 父元素倒数第 n 个子元素
+//    :nth-child(an+b) 父元素第 a·k+b 个子元素（1-based，支持 odd / even）
+//    :nth-last-child(an+b) 父元素倒数第 a·k+b 个子元素
+//    :first-child / :last-child
+//    :visible         有效可见；作用于最右侧 token 时整棵跳过不可见子树
+//    :enabled         可用
+//    :focused         持有活动焦点
+//    :not(A, B)       不匹配列表中任一选择器
+//    :has(A, > B)     存在满足相对选择器的后代 / 子节点 / 后续兄弟（查询内记忆化）
+//
+//  querySelectorMulti() 在一次遍历中求值一组选择器，供 resolve_many 使用。
+//  querySelectorAll() / countSelectorAll() 可指定结果窗口（offset / limit），
+//  窗口收满即停止遍历；计数模式不构建结果列表。
+//
+//  结果缓存（setResultCacheCapacity() 启用）：querySelector / querySelectorAll /
+//  countSelectorAll 的结果按 (根, 树类型, 选择器, 窗口, 模式) 缓存，
+//  以 UiTreeWatcher 的 generation 判定失效——结构变化与选择器依赖属性的
+//  notify 信号都会使其递增，未变化时直接返回、不遍历。
+//  依赖无 notify 信号属性的选择器与 debug 调用不走缓存。
+//
+//  snapshot() 把根下的子树采集为不可变的 UiSceneSnapshot（UiSceneSnapshot.h），
+//  之后可用 UiSnapshotQuery 在工作线程上查询。
+//
+//  解析与匹配核心见 UiSelectorSyntax.h / UiSelectorEngine.h，
+//  本类按根节点选择树特征类并分派到对应的 SelectorEngine：
+//    TreeKind::Auto    QWidget 根 → WidgetTree，其余 → QuickTree
+//    TreeKind::Quick   QML 场景树（QQuickItem 视觉树 + QObject 树）
+//    TreeKind::Widget  QWidget 树，类型名按 QMetaObject 继承链匹配
+//    TreeKind::Object  纯 QObject::children() 树
 //
 //  CMakeLists.txt 依赖：
 //    find_package(Qt5 REQUIRED COMPONENTS Qml Quick)
 //    target_link_libraries(... Qt5::Qml Qt5::Quick)
 // ════════════════════════════════════════════════════════════════
+// 结果窗口：按文档顺序跳过前 offset 个命中，最多取 limit 个（<= 0 不限）
+struct SelectorRange {
+    int offset = 0;
+    int limit  = 0;
+};
+
+// 结果缓存统计
+struct SelectorCacheStats {
+    quint64 hits     = 0;
+    quint64 misses   = 0;
+    quint64 bypassed = 0;  // 不可缓存的调用（依赖无法监听的属性、debug）
+    int     size     = 0;
+    int     capacity = 0;
+};
+
 class QmlQuerySelector : public QObject {
     Q_OBJECT
 
 public:
+    enum class TreeKind { Auto, Quick, Widget, Object };
+
     explicit QmlQuerySelector(QObject* parent = nullptr);
 
     // 调试接口（测试用）：返回解析后的 SelectorChain 的可读文本
@@ -136,94 +96,85 @@ public:
                                      QString* error = nullptr, bool debug = false);
     QList<QObject*> querySelectorAll(QObject* root, const QString& selector,
                                      QString* error = nullptr, bool debug = false);
-
-    void clearCache() { parseCache_.clear(); }
+    QList<QObject*> querySelectorAll(QObject* root, const QString& selector,
+                                     const SelectorRange& range,
+                                     QString* error = nullptr, bool debug = false);
+    // 只计数、不构建结果列表，返回窗口内的命中数；"是否存在" 用 limit = 1
+    int             countSelectorAll(QObject* root, const QString& selector,
+                                     const SelectorRange& range = SelectorRange(),
+                                     QString* error = nullptr);
+
+    // 多选择器单遍遍历：返回与 selectors 等长的结果列表，各自按文档顺序。
+    // 单个选择器解析失败只影响它自己——结果为空，原因写入 (*errors)[i]，
+    // 成功项对应空串。firstOnly 时每个选择器只取第一个命中，
+    // 全部命中后遍历提前结束。
+    QVector<QList<QObject*>> querySelectorMulti(QObject* root, const QStringList& selectors,
+                                                QStringList* errors = nullptr,
+                                                bool firstOnly = false, bool debug = false);
+
+    // 清空解析缓存与结果缓存
+    void clearCache();
+
+    // 结果缓存容量（条目数，LRU 淘汰）；0 关闭并释放监听
+    void               setResultCacheCapacity(int capacity);
+    int                resultCacheCapacity() const { return results_.maxCost(); }
+    SelectorCacheStats resultCacheStats() const;
+
+    // 在 GUI 线程上采集快照，树类型按第一个根选择；没有有效根时返回空指针
+    std::shared_ptr<const UiSceneSnapshot> snapshot(const QList<QObject*>& roots,
+                                                    const QSet<QString>& properties);
+
+    // 解析选择器（含逗号分支）并汇总其依赖；解析失败返回 false
+    bool dependencies(const QString& selector, SelectorDependencies* deps, QString* error = nullptr);
+
+    // 增量重查（活动查询）使用，父子关系与查询遍历的树一致：
+    // node 是否位于 scope 子树内（含 scope 自身），树类型按 scope 选择
+    bool     isWithin(QObject* node, QObject* scope) const;
+    // 从 node 重查的起点：node 到 root（含）路径上最靠上的原子容器，没有时为 node。
+    // 整树 DFS 不进入原子容器，从其内部开始查询会得到整树查询之外的命中
+    QObject* requeryScope(QObject* root, QObject* node) const;
+
+    void     setTreeKind(TreeKind kind) { treeKind_ = kind; }
+    TreeKind treeKind() const           { return treeKind_; }
 
 private:
-    // ── 解析 ──────────────────────────────────────────────────
-    SelectorChain parse(const QString& selector);
-
-    // Token 语法解析器（手写递归下降，解析失败抛 SelectorParseError）
-    SelectorToken parseToken(const QString& src, int& pos);
-
-    void          parseAttrSelector(const QString& src, int& pos, SelectorToken& token);
-    void          parsePseudoClass (const QString& src, int& pos, SelectorToken& token);
-    QString       parseIdent       (const QString& src, int& pos);
-    QString       parseAttrValue   (const QString& src, int& pos);
-    QString       parseAttrOp      (const QString& src, int& pos);
-    int           parseInteger     (const QString& src, int& pos);
-    void          skipSpaces       (const QString& src, int& pos);
-    void          expect           (const QString& src, int& pos, QChar ch);
-
-    // ── 匹配 ──────────────────────────────────────────────────
-    bool matchToken   (QObject* obj, const SelectorToken& token) const;
-    bool matchChainRTL(QObject* obj, const SelectorChain& chain, int idx) const;
-
-    // ── 遍历 ──────────────────────────────────────────────────
-    void collectAll(QObject* node,
-                    const SelectorChain& chain,
-                    QList<QObject*>& results,
-                    bool stopAtFirst);
-    void collectOrdered(QObject* node,
-                        const QSet<QObject*>& matched,
-                        QList<QObject*>& ordered);
-
-    // ── 布隆过滤器 ────────────────────────────────────────────
-    BloomFilter buildBloom(QObject* node) const;
-
-    // ── 节点访问（双轨策略）──────────────────────────────────
-    QList<QObject*> visualChildren  (QObject* obj) const;
-    QList<QObject*> declaredChildren(QObject* obj) const;
-    QList<QObject*> siblings        (QObject* obj, bool onlyPreceding) const;
-
-    // ── 元对象工具 ────────────────────────────────────────────
-    QString  resolveTypeName(QObject* obj) const;
-    QVariant property       (QObject* obj, const QString& name) const;
-
-    // ── 调试 ──────────────────────────────────────────────────
-    void debugTree(QObject* node, int depth) const;
-
-    // visualParent — 优先查 parentMap_，回退到 QObject::parent()
-    QObject* visualParent(QObject* obj) const;
-    // buildParentMap — 以 root 为根 DFS 遍历，填充 parentMap_
-    void buildParentMap(QObject* node, QObject* parent);
-
-    // 调试：返回解析后的 SelectorChain 的可读文本（仅供测试）
-    QString debugParse(const QString& selector);
-
-    // ── 解析缓存 ──────────────────────────────────────────────
-    QHash<QString, SelectorChain> parseCache_;
-    mutable QHash<QObject*, QObject*> parentMap_;
+    TreeKind kindFor(QObject* root) const;
+
+    // 参数校验、按树类型分派与异常转换；results 为 nullptr 时只计数。
+    // api 为错误信息前缀。返回窗口内的命中数，失败返回 -1。
+    int query(const char* api, QObject* root, const QString& selector,
+              const SelectorRange& range, QList<QObject*>* results,
+              QString* error, bool debug);
+
+    struct CachedResult {
+        QPointer<QObject>        root;
+        quint64                  generation = 0;
+        int                      count = 0;
+        QList<QPointer<QObject>> objects;
+    };
+    // 选择器可缓存时登记其依赖并监听 root，返回 true
+    bool prepareCache(QObject* root, const QStringList& parts);
+    bool lookupCache(const QString& key, QObject* root, QList<QObject*>* results, int* count);
+    void storeCache(const QString& key, QObject* root, int count,
+                    const QList<QObject*>* results, int from);
+
+    // 在指定引擎上执行查询；parts 为按顶层逗号拆分后的子选择器
+    template <typename Tree>
+    int run(SelectorEngine<Tree>& engine, QObject* root, const QStringList& parts,
+            const SelectorRange& range, QList<QObject*>* results, bool debug);
+    // chains[i] 的命中归入第 owners[i] 个结果
+    template <typename Tree>
+    QVector<QList<QObject*>> runMulti(SelectorEngine<Tree>& engine, QObject* root,
+                                      const QList<SelectorChain>& chains, const QVector<int>& owners,
+                                      int slotCount, int limit, bool debug);
+
+    SelectorParser             parser_;
+    TreeKind                   treeKind_ = TreeKind::Auto;
+    SelectorEngine<QuickTree>  quick_;
+    SelectorEngine<WidgetTree> widgets_;
+    SelectorEngine<ObjectTree> objects_;
+
+    QCache<QString, CachedResult> results_{ 0 };
+    UiTreeWatcher*             watcher_ = nullptr;
+    SelectorCacheStats         stats_;
 };
-
-
-inline void log(const char *tag, const QString &msg)
-{
-    // 1. C++11 保证了 static 局部变量在多线程环境下只会被初始化一次。
-    // 这在纯头文件中是替代 Q_GLOBAL_STATIC 的最安全做法。
-    static QMutex mutex; 
-
-    // 静态文件指针：只会在第一次执行时初始化
-    static struct LogFile {
-        QFile file;
-        QTextStream stream;
-        LogFile() {
-            file.setFileName(QStringLiteral("debug.log"));
-            if (file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
-                stream.setDevice(&file);
-            }
-        }
-        ~LogFile() {
-            if (file.isOpen()) file.close();
-        }
-    } logStorage;
-
-    if (logStorage.file.isOpen()) {
-        logStorage.stream << QDateTime::currentDateTime().toString(Qt::ISODateWithMs)
-                          << " [" << tag << "] " << msg << "\n";
-        // 强制刷新缓冲区，确保实时写入磁盘
-        logStorage.stream.flush();
-    }
-}
-
-#define LOG(tag, msg) log(tag, msg)
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+
+// ════════════════════════════════════════════════════════════════
+//  UiRenderThrottle — 渲染节流（吞吐模式）
+//
+//  QQuickWindow 的 polish + 同步 + 渲染、顶层 QWidget 的重绘都由窗口上的
+//  QEvent::UpdateRequest 触发。在这些窗口上安装事件过滤器拦下该事件：
+//    · Suspend：全部拦下，直到恢复或 flush()
+//    · Throttle：拦下后合并，每 intervalMs 补发一次
+//    · Normal：不拦截
+//  被拦下的窗口记入 held_，恢复 / 补发时同步发送一次 UpdateRequest，
+//  积累的脏区域与 polish 请求一并处理。
+//
+//  属性与动作不受影响；QWidget 的布局走 LayoutRequest，照常更新。
+//  QtQuick 的 polish（Row / Column / Layout 等定位）随渲染推迟，
+//  挂起期间读取这类几何属性前应先 flush()。截图前处理器会自动 flush()。
+//  窗口集合在 setMode() 时从根对象收集，之后新建的窗口不受影响。
+// ════════════════════════════════════════════════════════════════
+class UiRenderThrottle : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Mode { Normal, Throttle, Suspend };
+
+    explicit UiRenderThrottle(QObject* parent = nullptr);
+    ~UiRenderThrottle() override;
+
+    // 切换模式并（重新）收集 roots 下的窗口；切回 Normal 时补发被拦下的更新
+    void setMode(const QList<QObject*>& roots, Mode mode, int intervalMs = kDefaultIntervalMs);
+    Mode mode() const { return mode_; }
+
+    // 立即补发被拦下的更新并处理事件，模式不变
+    void flush();
+    // 是否有被拦下、尚未补发的更新
+    bool hasHeld() const { return !held_.isEmpty(); }
+
+    // {mode, intervalMs, windows, suppressed}
+    QJsonObject state() const;
+
+    // "normal" / "throttle" / "suspend"；无法识别时 *ok 为 false
+    static Mode parseMode(const QString& name, bool* ok);
+    static QString modeName(Mode mode);
+
+    static const int kDefaultIntervalMs = 250;
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    void addWindow(QObject* window);
+    void onWindowDestroyed(QObject* window);
+    void deliverHeld();
+
+    Mode            mode_ = Mode::Normal;
+    QSet<QObject*>  windows_;
+    QSet<QObject*>  held_;          // 有被拦下的 UpdateRequest
+    QTimer          timer_;         // Throttle 模式的补发节拍
+    bool            delivering_ = false;
+    quint64         suppressed_ = 0;
+};
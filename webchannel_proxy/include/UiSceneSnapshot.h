@@ -0,0 +1,219 @@
+#pragma once
+
+#include "UiQMLQuery.h"
+#include "UiSelectorEngine.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+#include <memory>
+
+class QThreadPool;
+
+// ════════════════════════════════════════════════════════════════
+//  UiSceneSnapshot — 不可变的扁平场景快照
+//
+//  GUI 线程单遍采集，之后只读，可在任意线程、被多个线程同时查询：
+//    · 结构按列存储（SoA）：parent / firstChild / nextSibling / subtreeEnd，
+//      节点下标即文档顺序（先序），子树是连续区间 [n, subtreeEnd(n))
+//    · 类型按类名驻留为 typeId，类型表记录匹配键、显示名与原子容器标志
+//    · objectName、状态位（自身可见 / 可用 / 焦点）与采集时指定的属性值各占一列
+//    · 声明顺序的子节点（兄弟组合器、:nth-child 用）单独存一份；
+//      只出现在声明子列表里、不参与遍历的节点追加在 [treeSize, size) 区间
+//
+//  采集沿用 QuickTree / WidgetTree / ObjectTree 的遍历与类型规则，
+//  因此快照上的查询结果与采集时刻的实时查询一致，但有两点差别：
+//    · 根以上的祖先不在快照内，跨越根的后代 / 子组合器不会命中
+//    · 只能判定采集过的属性（UiSnapshotQuery 会拒绝依赖未采集属性的选择器）
+//
+//  QObject 指针只在 GUI 线程上通过 object() 取用，对象销毁后返回 nullptr。
+// ════════════════════════════════════════════════════════════════
+class UiSceneSnapshot {
+public:
+    struct Type {
+        QByteArray       className;
+        QString          name;    // typeLabel
+        QVector<QString> keys;    // 类型匹配键（小写）；控件树为整条继承链
+        bool             atomic = false;
+    };
+
+    enum Flag : quint8 { Shown = 0x1, Enabled = 0x2, Focused = 0x4 };
+
+    // 在 GUI 线程上采集 roots 下的子树（按顺序拼接）；properties 为需要按列保存的属性，
+    // classChainTypes 为 true 时类型按 QMetaObject 继承链匹配（控件树）
+    template <typename Tree>
+    static std::shared_ptr<const UiSceneSnapshot> capture(Tree& tree, const QList<QObject*>& roots,
+                                                          const QSet<QString>& properties,
+                                                          bool classChainTypes);
+
+    int size()     const { return parent_.size(); }
+    int treeSize() const { return treeSize_; }
+    const QVector<int>&  roots()      const { return roots_; }
+    const QSet<QString>& properties() const { return properties_; }
+
+    int parent     (int n) const { return parent_.at(n); }
+    int firstChild (int n) const { return firstChild_.at(n); }
+    int nextSibling(int n) const { return nextSibling_.at(n); }
+    int subtreeEnd (int n) const { return subtreeEnd_.at(n); }
+
+    // 声明顺序的子节点：declared()[declaredBegin(n) .. declaredBegin(n + 1))
+    int                 declaredBegin(int n) const { return declStart_.at(n); }
+    const QVector<int>& declared()           const { return declList_; }
+
+    const Type&    type      (int n) const { return types_.at(typeIds_.at(n)); }
+    int            typeId    (int n) const { return typeIds_.at(n); }
+    const QString& objectName(int n) const { return names_.at(n); }
+    bool           hasFlag   (int n, Flag f) const { return flags_.at(n) & f; }
+
+    // 属性值；objectName 直接取名称列，未采集的属性返回无效值
+    QVariant value(int n, const QString& name) const;
+    // 按列访问：column() 未采集时返回 -1
+    int                      column(const QString& name) const { return columns_.value(name, -1); }
+    const QVector<QVariant>& columnValues(int column)   const { return values_.at(column); }
+
+    // 仅限 GUI 线程
+    QObject* object(int n) const { return objects_.at(n).data(); }
+
+    // 与处理器的 describeTarget 字段一致（采集时未取的属性省略）
+    QJsonObject describe(int n) const;
+
+private:
+    UiSceneSnapshot() = default;
+
+    int  internType(const QObject* obj, bool classChainTypes, SelectorDetail::QmlTypeCache& cache,
+                    QHash<QByteArray, int>& ids);
+    int  appendNode(QObject* obj, int parent, quint8 flags, int typeId);
+
+    int                          treeSize_ = 0;
+    QVector<int>                 roots_;
+    QSet<QString>                properties_;
+
+    QVector<int>                 parent_;
+    QVector<int>                 firstChild_;
+    QVector<int>                 nextSibling_;
+    QVector<int>                 subtreeEnd_;
+    QVector<int>                 declStart_;   // size() + 1 项
+    QVector<int>                 declList_;
+
+    QVector<int>                 typeIds_;
+    QVector<Type>                types_;
+    QVector<QString>             names_;
+    QVector<quint8>              flags_;
+    QHash<QString, int>          columns_;     // 属性名 → values_ 列号
+    QVector<QVector<QVariant>>   values_;
+    QVector<QPointer<QObject>>   objects_;
+};
+
+// ════════════════════════════════════════════════════════════════
+//  SnapshotTree — UiSceneSnapshot 上的树特征类
+//
+//  节点即快照下标；所有判定只读快照，不接触 QObject，
+//  每个线程使用自己的 SelectorEngine<SnapshotTree>。
+// ════════════════════════════════════════════════════════════════
+struct SnapshotNode {
+    int index = -1;
+
+    explicit operator bool() const { return index >= 0; }
+    bool operator==(const SnapshotNode& o) const { return index == o.index; }
+    bool operator!=(const SnapshotNode& o) const { return index != o.index; }
+};
+
+inline uint qHash(const SnapshotNode& n, uint seed = 0) { return ::qHash(n.index, seed); }
+
+class SnapshotTree {
+public:
+    using Node = SnapshotNode;
+
+    void setSnapshot(const UiSceneSnapshot* snapshot) { snap_ = snapshot; }
+    const UiSceneSnapshot* snapshot() const { return snap_; }
+    void reset() {}
+
+    QVector<Node> children(const Node& n) const;
+    QVector<Node> declaredChildren(const Node& n) const;
+    Node          parent(const Node& n) const { return { snap_->parent(n.index) }; }
+
+    bool    matchType  (const Node& n, const SelectorToken& token) const {
+        return snap_->type(n.index).keys.contains(token.typeKey);
+    }
+    void    addTypeKeys(const Node& n, BloomFilter& bf) const;
+    bool    descendInto(const Node& n, const SelectorChain& chain) const;
+    bool    isAtomic   (const Node& n) const { return snap_->type(n.index).atomic; }
+    QString typeLabel  (const Node& n) const { return snap_->type(n.index).name; }
+
+    bool isShown  (const Node& n) const { return snap_->hasFlag(n.index, UiSceneSnapshot::Shown); }
+    bool isEnabled(const Node& n) const { return snap_->hasFlag(n.index, UiSceneSnapshot::Enabled); }
+    bool hasFocus (const Node& n) const { return snap_->hasFlag(n.index, UiSceneSnapshot::Focused); }
+
+    QVariant attribute(const Node& n, const QString& name) const { return snap_->value(n.index, name); }
+
+private:
+    const UiSceneSnapshot* snap_ = nullptr;
+};
+
+// ════════════════════════════════════════════════════════════════
+//  UiSnapshotQuery — 快照上的选择器查询
+//
+//  自带解析器与引擎，不共享可变状态：每个工作线程各建一个实例，
+//  同一个实例不能并发使用。多个根按顺序拼接，窗口语义同
+//  QmlQuerySelector::querySelectorAll。
+//
+//  并行模式（querySelectorAllParallel / findText 传入线程池）：
+//  快照的遍历节点区间 [0, treeSize) 是文档顺序，按下标切成
+//  线程数 × kChunksPerThread 块提交到 QThreadPool，空闲线程按队列
+//  领取下一块，负载不均时由其他线程接手。每块用自己的引擎逐个节点
+//  匹配最右侧 token 并向上验证祖先，再检查祖先链上的原子容器策略；
+//  各块结果按块顺序拼接即为文档顺序，最后再取窗口（不会提前停止）。
+//  调用线程在等待时会执行尚未开始的块（QFuture 等待时的窃取），
+//  因此在线程池工作线程里调用也不会死锁。
+// ════════════════════════════════════════════════════════════════
+class UiSnapshotQuery {
+public:
+    explicit UiSnapshotQuery(std::shared_ptr<const UiSceneSnapshot> snapshot);
+
+    // 命中节点下标按文档顺序写入 *results（nullptr 时只计数）；
+    // 返回窗口内命中数，失败返回 -1 并写入 *error
+    int querySelectorAll(const QString& selector, const SelectorRange& range,
+                         QVector<int>* results, QString* error = nullptr);
+    // 同上，分块并行匹配；pool 为 nullptr 时使用 QThreadPool::globalInstance()
+    int querySelectorAllParallel(const QString& selector, const SelectorRange& range,
+                                 QVector<int>* results, QString* error = nullptr,
+                                 QThreadPool* pool = nullptr);
+
+    // 文本搜索的比较方式与结果窗口，字段含义同处理器的 "text" 目标
+    // （"match": "exact" | "contains"，"caseSensitive"）
+    struct TextMatch {
+        bool                contains = false;
+        Qt::CaseSensitivity cs       = Qt::CaseSensitive;
+        SelectorRange       range;
+    };
+
+    // 文本搜索：properties 中任一属性的字符串值匹配 value 的节点（文档顺序），
+    // 窗口内的命中写入 *results（nullptr 时只计数），返回窗口内命中数；pool 非空时分块并行
+    int findText(const QString& value, const QStringList& properties,
+                 QVector<int>* results, QThreadPool* pool = nullptr,
+                 const TextMatch& match = TextMatch()) const;
+
+    // 选择器求值需要采集的属性；在 GUI 线程采集快照前调用
+    static bool requiredProperties(const QString& selector, QSet<QString>* properties,
+                                   QString* error = nullptr);
+
+    const UiSceneSnapshot& snapshot() const { return *snapshot_; }
+
+    static const int kChunksPerThread = 4;
+
+private:
+    // 解析选择器并检查其依赖的属性都已采集
+    bool compile(const QString& selector, QList<SelectorChain>* chains, QString* error);
+
+    std::shared_ptr<const UiSceneSnapshot> snapshot_;
+    SelectorParser                         parser_;
+    SelectorEngine<SnapshotTree>           engine_;
+};
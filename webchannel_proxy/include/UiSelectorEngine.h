@@ -0,0 +1,812 @@
+#pragma once
+
+#include "UiSelectorSyntax.h"
+
+#include <QObject>
+#include <QVariant>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QPair>
+#include <QWidget>
+
+#include <vector>
+
+class QQuickItem;
+
+// ════════════════════════════════════════════════════════════════
+//  选择器匹配核心：SelectorEngine<Tree>
+//
+//  解析结果（SelectorChain）与节点树无关；遍历、父子关系、
+//  类型名判定全部委托给 Tree 特征类，在编译期静态分派：
+//
+//    QuickTree   QQuickItem 视觉树（childItems）+ 非 Item 节点的 QObject 树
+//    WidgetTree  QWidget 控件树（忽略 QLayout / QAction 等非控件子对象）
+//    ObjectTree  纯 QObject::children() 树
+//
+//  Tree 需要提供：
+//    using Node                          节点句柄（可判空、可比较、可 qHash）
+//    static QObject* object(Node)        取底层 QObject（结果输出用）
+//    Node fromObject(QObject*)           从外部传入的根对象构造节点
+//    void reset()                        每次查询入口调用，清理遍历期缓存
+//    QVector<Node> children(Node)        子树遍历用的子节点
+//    QVector<Node> declaredChildren(Node)兄弟顺序 / :nth-child 用的子节点
+//    Node parent(Node)                   逻辑父节点
+//    bool matchType(Node, token)         类型名匹配（token.typeKey 非空时调用）
+//    void addTypeKeys(Node, BloomFilter&)布隆过滤器登记的类型键（小写）
+//    bool descendInto(Node, chain)       是否进入该节点子树（原子容器策略）
+//    bool isAtomic(Node)                 是否为原子容器（多选择器遍历据此收窄链集合）
+//    QString typeLabel(Node)             调试输出用类型名
+//    bool isShown(Node)                  自身可见标志（有效可见性由引擎沿父链合成）
+//    bool isEnabled(Node) / hasFocus(Node)  :enabled / :focused
+//    QVariant attribute(Node, name)      属性条件读取的属性值（无效值视为不匹配）
+//
+//  类型判定只在类型缓存未命中时走一次 QMetaObject，
+//  遍历路径上不再对每个节点做 qobject_cast。
+// ════════════════════════════════════════════════════════════════
+
+namespace SelectorDetail {
+
+// 类名 → QML 组件名：去掉 _(QMLTYPE|QML)_\d+ 后缀与 "QQuick" 前缀
+QString resolveQmlTypeName(const char* className);
+
+// 三级回退读取属性：Q_PROPERTY → 动态属性 → QQmlProperty
+QVariant readProperty(QObject* obj, const QString& name);
+
+// 属性条件判定；value 无效视为不匹配，op 为空时仅检查存在性
+bool matchAttribute(const QVariant& value, const AttributeCondition& cond);
+
+// ────────────────────────────────────────────────────────────────
+//  QmlTypeCache — 按类名缓存 QML 类型信息
+//
+//  QML 对象的 metaObject() 往往是逐实例的 VME 元对象，指针不能
+//  作为缓存键，这里以类名字符串为键（查找时 fromRawData 不分配）。
+//  条目只增不删，Qt 5 的 QHash 节点地址稳定，可以直接返回引用。
+// ────────────────────────────────────────────────────────────────
+struct QmlTypeInfo {
+    QString name;           // resolveQmlTypeName 结果
+    QString key;            // name 小写
+    bool    isItem = false; // 继承自 QQuickItem
+    bool    atomic = false; // 非容器型自定义组件（_QMLTYPE_），默认不进入内部
+    // 非 Item 对象（Popup 等）的状态属性下标，-1 表示没有该属性
+    int     visibleProp = -1;
+    int     enabledProp = -1;
+    int     focusProp   = -1;
+};
+
+class QmlTypeCache {
+public:
+    const QmlTypeInfo& info(const QObject* obj);
+
+private:
+    QHash<QByteArray, QmlTypeInfo> cache_;
+};
+
+bool chainMentionsType(const SelectorChain& chain, const QString& key);
+
+// 按属性下标读取 bool 属性；index < 0 时返回 fallback
+bool readBoolProperty(QObject* obj, int index, bool fallback);
+
+// token 是否带有指定伪类
+bool hasPseudo(const SelectorToken& token, PseudoClass::Type type);
+
+}  // namespace SelectorDetail
+
+// ════════════════════════════════════════════════════════════════
+//  ObjectTree — 纯 QObject 树
+// ════════════════════════════════════════════════════════════════
+class ObjectTree {
+public:
+    using Node = QObject*;
+
+    static QObject* object(Node n) { return n; }
+    Node fromObject(QObject* obj) const { return obj; }
+    void reset() {}
+
+    QVector<Node> children(Node n) const;
+    QVector<Node> declaredChildren(Node n) const { return children(n); }
+    Node          parent(Node n) const { return n->parent(); }
+
+    bool    matchType  (Node n, const SelectorToken& token) const;
+    void    addTypeKeys(Node n, BloomFilter& bf) const;
+    bool    descendInto(Node n, const SelectorChain& chain) const;
+    bool    isAtomic   (Node n) const { return types_.info(n).atomic; }
+    QString typeLabel  (Node n) const;
+
+    // 没有对应属性的对象视为可见、可用、无焦点
+    bool isShown  (Node n) const;
+    bool isEnabled(Node n) const;
+    bool hasFocus (Node n) const;
+
+    QVariant attribute(Node n, const QString& name) const { return SelectorDetail::readProperty(n, name); }
+
+private:
+    mutable SelectorDetail::QmlTypeCache types_;
+};
+
+// ════════════════════════════════════════════════════════════════
+//  WidgetTree — QWidget 控件树
+//
+//  类型名沿 superClass() 链匹配，"QAbstractButton" 可以命中
+//  QPushButton / QCheckBox；继承链按 QMetaObject 缓存。
+// ════════════════════════════════════════════════════════════════
+class WidgetTree {
+public:
+    using Node = QWidget*;
+
+    static QObject* object(Node n) { return n; }
+    Node fromObject(QObject* obj) const {
+        return obj && obj->isWidgetType() ? static_cast<QWidget*>(obj) : nullptr;
+    }
+    void reset() {}
+
+    QVector<Node> children(Node n) const;
+    QVector<Node> declaredChildren(Node n) const { return children(n); }
+    Node          parent(Node n) const { return n->parentWidget(); }
+
+    bool    matchType  (Node n, const SelectorToken& token) const;
+    void    addTypeKeys(Node n, BloomFilter& bf) const;
+    bool    descendInto(Node, const SelectorChain&) const { return true; }
+    bool    isAtomic   (Node) const { return false; }
+    QString typeLabel  (Node n) const;
+
+    // isHidden() 只反映自身的显隐（QStackedWidget 非当前页、hide() 过的控件），
+    // 与祖先合成后即为相对根的有效可见性
+    bool isShown  (Node n) const { return !n->isHidden(); }
+    bool isEnabled(Node n) const { return n->isEnabled(); }
+    bool hasFocus (Node n) const { return n->hasFocus(); }
+
+    QVariant attribute(Node n, const QString& name) const { return SelectorDetail::readProperty(n, name); }
+
+private:
+    const QVector<QString>& classChain(Node n) const;
+
+    mutable QHash<const QMetaObject*, QVector<QString>> chains_;
+};
+
+// ════════════════════════════════════════════════════════════════
+//  QuickTree — QML 场景树（双轨策略）
+//
+//  QQuickItem 节点：子树遍历走 childItems()，另补 QWindow 子对象
+//                   （弹出窗口、遮罩层等不在可视树里的窗口）；
+//  其他节点（QQuickWindow、根 QObject）：走 QObject::children()。
+//  兄弟顺序 / :nth-child 使用 QObject::children() 的声明顺序。
+//
+//  Item 句柄在构造节点时一次确定，后续遍历直接使用。
+// ════════════════════════════════════════════════════════════════
+struct QuickNode {
+    QObject*    object = nullptr;
+    QQuickItem* item   = nullptr;   // object 为 QQuickItem 时非空
+
+    explicit operator bool() const { return object != nullptr; }
+    bool operator==(const QuickNode& o) const { return object == o.object; }
+    bool operator!=(const QuickNode& o) const { return object != o.object; }
+};
+
+inline uint qHash(const QuickNode& n, uint seed = 0) { return ::qHash(n.object, seed); }
+
+class QuickTree {
+public:
+    using Node = QuickNode;
+
+    static QObject* object(const Node& n) { return n.object; }
+    Node fromObject(QObject* obj) const;
+    void reset() {}
+
+    QVector<Node> children(const Node& n) const;
+    QVector<Node> declaredChildren(const Node& n) const;
+    Node          parent(const Node& n) const;
+
+    bool    matchType  (const Node& n, const SelectorToken& token) const;
+    void    addTypeKeys(const Node& n, BloomFilter& bf) const;
+    bool    descendInto(const Node& n, const SelectorChain& chain) const;
+    bool    isAtomic   (const Node& n) const { return types_.info(n.object).atomic; }
+    QString typeLabel  (const Node& n) const;
+
+    // Item 取 QQuickItem 的有效状态；QWindow 取窗口状态；
+    // 其余对象（Popup、Drawer 等）读 visible / enabled / activeFocus 属性
+    bool isShown  (const Node& n) const;
+    bool isEnabled(const Node& n) const;
+    bool hasFocus (const Node& n) const;
+
+    QVariant attribute(const Node& n, const QString& name) const {
+        return SelectorDetail::readProperty(n.object, name);
+    }
+
+private:
+    mutable SelectorDetail::QmlTypeCache types_;
+};
+
+// ════════════════════════════════════════════════════════════════
+//  SelectorEngine — 与树类型无关的匹配核心
+//
+//    · Bloom Filter 前置剪枝：子树一定不含最右侧 token 的类型时整棵跳过
+//    · RTL 匹配：最右侧 token 命中后再由 matchChainRTL() 向左回溯；
+//      后代 / 通用兄弟组合器的回溯按 (节点, 链下标) 记忆化，
+//      每个状态在一次查询中只求值一次（见 matchChainRTL）
+//    · 结果窗口：offset / limit 收满即停止遍历（querySelector() 即 limit = 1），
+//      不传结果列表时只计数
+//    · 多选择器单遍遍历：collectMulti() 按最右侧 token 的类型键分桶，
+//      每个节点只对可能命中它的桶求值，布隆过滤器按桶剪枝
+//    · :visible 剪枝：最右侧 token 要求 :visible 时，有效不可见的节点
+//      连同整棵子树一起跳过（多页面应用中隐藏页占了遍历的大头）
+//    · 子节点位置表：每个父节点的声明子列表与下标索引在查询内只构建一次，
+//      + / ~ / :nth-child(an+b) 的位置判断为 O(1)，不再逐候选 indexOf
+//    · :has 记忆化：(节点, 子选择器) → 结果，查询期间有效；
+//      后代搜索按 (节点, 相对选择器段) 记忆化，嵌套候选不会重复遍历同一子树
+// ════════════════════════════════════════════════════════════════
+template <typename Tree>
+class SelectorEngine {
+public:
+    using Node = typename Tree::Node;
+
+    Tree&       tree()       { return tree_; }
+    const Tree& tree() const { return tree_; }
+
+    // 每次查询入口调用：清理布隆过滤器缓存与树的遍历期状态
+    void reset() {
+        tree_.reset();
+        bloomCache_.clear();
+        visibleCache_.clear();
+        hasCache_.clear();
+        descendantCache_.clear();
+        childTables_.clear();
+        rtlCache_.clear();
+    }
+
+    // 按文档顺序收集匹配节点：跳过前 offset 个命中，最多保留 limit 个
+    // （<= 0 不限），窗口收满即停止遍历。results 为 nullptr 时只计数。
+    // 返回遍历中遇到的命中数（含被跳过的，提前停止时不超过 offset + limit）。
+    int collect(const Node& root, const SelectorChain& chain, QVector<Node>* results,
+                int offset = 0, int limit = 0);
+    // 多选择器单遍遍历：chains[i] 的命中归入第 owners[i] 个槽（共 slotCount 个），
+    // 各槽按文档顺序且不重复（同一槽可以有多条逗号分支）。
+    // 窗口语义同 collect、逐槽独立，所有槽收满后遍历提前结束。
+    // results 非空时写入各槽命中；返回各槽遇到的命中数。
+    QVector<int> collectMulti(const Node& root, const QList<SelectorChain>& chains,
+                              const QVector<int>& owners, int slotCount,
+                              QVector<QVector<Node>>* results, int offset = 0, int limit = 0);
+
+    bool matchToken   (const Node& n, const SelectorToken& token) const;
+    bool matchChainRTL(const Node& n, const SelectorChain& chain, int idx) const;
+    // n 是否匹配完整的选择器链
+    bool matches      (const Node& n, const SelectorChain& chain) const;
+
+    void debugTree(const Node& n, int depth) const;
+
+    // 有效可见性：自身可见且所有祖先可见，按节点缓存
+    bool effectiveVisible(const Node& n) const;
+
+private:
+    // 结果窗口：跳过前 skip 个命中，最多保留 limit 个（<= 0 不限）
+    struct Window {
+        QVector<Node>* out = nullptr;  // nullptr 时只计数
+        int  skip  = 0;
+        int  limit = 0;
+        int  seen  = 0;                // 已遇到的命中数（含跳过的）
+        Node last  = Node();           // 最近一次命中，同槽多条分支去重
+
+        bool full() const { return limit > 0 && seen >= skip + limit; }
+        void hit(const Node& n) {
+            last = n;
+            if (++seen > skip && out) out->append(n);
+        }
+    };
+
+    // 窗口收满时返回 true，调用方随即停止遍历
+    bool collectFrom(const Node& node, const SelectorChain& chain,
+                     Window& window, bool pruneHidden);
+
+    // collectMulti 的分桶：最右侧 token 类型键与 :visible 要求相同的链归为一组
+    struct ChainGroup {
+        QString      typeKey;              // 空串表示不限类型
+        bool         visibleOnly = false;  // 最右侧 token 含 :visible
+        QVector<int> chains;
+    };
+    struct MultiState {
+        const QList<SelectorChain>* chains;
+        const QVector<int>*         owners;
+        QVector<Window>             windows;  // 每槽一个
+        int                         pending;  // 尚未收满的槽数
+    };
+    void collectMultiFrom(const Node& node, const QVector<const ChainGroup*>& groups,
+                          MultiState& state);
+
+    BloomFilter   bloom(const Node& n);
+    // 父节点的声明子列表及其下标索引
+    struct ChildTable {
+        QVector<Node>   nodes;
+        QHash<Node, int> index;
+    };
+    const ChildTable& childTable(const Node& parent) const;
+    // n 所在的父节点位置表，*index 为 n 的 0-based 下标；
+    // 没有父节点或 n 不在父节点的声明子列表中时返回 nullptr
+    const ChildTable* locate(const Node& n, int* index) const;
+
+    // :has 相对选择器求值
+    bool hasRelative      (const Node& anchor, const PseudoClass& pc) const;
+    bool matchRelative    (const Node& anchor, const SelectorChain& rel, int idx) const;
+    bool relativeStep     (const Node& n, const SelectorChain& rel, int idx) const;
+    bool descendantMatches(const Node& anchor, const SelectorChain& rel, int idx) const;
+
+    using MemoKey = QPair<Node, quintptr>;
+
+    Tree tree_;
+    // 子树布隆过滤器缓存，每次查询入口清空
+    QHash<Node, BloomFilter> bloomCache_;
+    // 有效可见性缓存：遍历自顶向下填充，祖先总是先于后代写入
+    mutable QHash<Node, bool> visibleCache_;
+    // (锚点, :has 参数列表) → 结果
+    mutable QHash<MemoKey, bool> hasCache_;
+    // (锚点, 相对选择器段) → 子树中是否存在满足该段及其右侧各段的节点
+    mutable QHash<MemoKey, bool> descendantCache_;
+    // 父节点 → 位置表，按需构建
+    mutable QHash<Node, ChildTable> childTables_;
+    // (节点, &chain[idx]) → matchChainRTL 结果，仅记录 ' ' 与 '~' 两种组合器
+    mutable QHash<MemoKey, bool> rtlCache_;
+};
+
+// ────────────────────────────────────────────────────────────────
+//  collect — DFS 遍历子树，按文档顺序收集匹配节点
+//
+//  children() 已包含 QWindow 子节点，布隆过滤器覆盖同一集合，
+//  因此剪枝后无需再单独补查窗口轨道。
+//  窗口收满（limit 个命中）时整个递归立即返回：
+//  "前 20 行" 或 "是否存在错误提示" 的代价与答案规模成正比，而非整棵树。
+// ────────────────────────────────────────────────────────────────
+template <typename Tree>
+int SelectorEngine<Tree>::collect(const Node& root, const SelectorChain& chain,
+                                  QVector<Node>* results, int offset, int limit)
+{
+    if (!root || chain.isEmpty()) return 0;
+    Window window;
+    window.out   = results;
+    window.skip  = qMax(0, offset);
+    window.limit = limit;
+    const bool pruneHidden = SelectorDetail::hasPseudo(chain.last().token, PseudoClass::Visible);
+    collectFrom(root, chain, window, pruneHidden);
+    return window.seen;
+}
+
+template <typename Tree>
+bool SelectorEngine<Tree>::collectFrom(const Node& node, const SelectorChain& chain,
+                                       Window& window, bool pruneHidden)
+{
+    // 不可见节点的后代一定不可见，整棵子树都不可能命中 :visible
+    if (pruneHidden && !effectiveVisible(node)) return false;
+
+    const SelectorToken& rightmost = chain.last().token;
+    if (!rightmost.typeKey.isEmpty() && !bloom(node).mayContain(rightmost.typeKey))
+        return false;
+
+    if (matchToken(node, rightmost) && matchChainRTL(node, chain, chain.size() - 2)) {
+        window.hit(node);
+        if (window.full()) return true;
+    }
+
+    if (!tree_.descendInto(node, chain)) return false;
+
+    for (const Node& child : tree_.children(node)) {
+        if (collectFrom(child, chain, window, pruneHidden)) return true;
+    }
+    return false;
+}
+
+// ────────────────────────────────────────────────────────────────
+//  collectMulti — 多个选择器共用一次 DFS
+//
+//  页面对象层在每次导航后要解析几十个选择器，逐个 collect 会让
+//  每个选择器各走一遍整棵树。这里把所有链按 (类型键, :visible)
+//  分桶后一起下行：
+//    · 布隆过滤器与 :visible 剪枝按桶进行，子树里不可能出现的桶
+//      不再传给子节点，桶全部淘汰时整棵子树跳过
+//    · 每个节点对每个桶只做一次类型判定，命中后才逐链 RTL 验证
+//    · 原子容器只保留显式提到该类型的链继续下行
+//  RTL / :has / 位置表等查询内缓存对所有链共享。
+//  逗号选择器同样走这里（所有分支属于同一个槽），一次遍历直接得到
+//  文档顺序的并集，不再需要按命中集合二次遍历整理顺序。
+// ────────────────────────────────────────────────────────────────
+template <typename Tree>
+QVector<int> SelectorEngine<Tree>::collectMulti(const Node& root, const QList<SelectorChain>& chains,
+                                                const QVector<int>& owners, int slotCount,
+                                                QVector<QVector<Node>>* results, int offset, int limit)
+{
+    QVector<int> counts(slotCount, 0);
+    if (results) {
+        results->clear();
+        results->resize(slotCount);
+    }
+    if (!root || chains.isEmpty()) return counts;
+
+    QHash<QPair<QString, bool>, int> groupIndex;
+    std::vector<ChainGroup> groups;
+    QSet<int> usedSlots;
+    for (int i = 0; i < chains.size(); ++i) {
+        if (chains[i].isEmpty()) continue;
+        const SelectorToken& rightmost = chains[i].last().token;
+        const QPair<QString, bool> key(rightmost.typeKey,
+                                       SelectorDetail::hasPseudo(rightmost, PseudoClass::Visible));
+        auto it = groupIndex.find(key);
+        if (it == groupIndex.end()) {
+            it = groupIndex.insert(key, int(groups.size()));
+            groups.push_back(ChainGroup{ key.first, key.second, {} });
+        }
+        groups[it.value()].chains.append(i);
+        usedSlots.insert(owners[i]);
+    }
+
+    QVector<const ChainGroup*> active;
+    active.reserve(int(groups.size()));
+    for (const ChainGroup& g : groups) active.append(&g);
+
+    MultiState state{ &chains, &owners, QVector<Window>(slotCount), usedSlots.size() };
+    for (int i = 0; i < slotCount; ++i) {
+        Window& w = state.windows[i];
+        w.out   = results ? &(*results)[i] : nullptr;
+        w.skip  = qMax(0, offset);
+        w.limit = limit;
+    }
+    if (state.pending > 0) collectMultiFrom(root, active, state);
+
+    for (int i = 0; i < slotCount; ++i) counts[i] = state.windows.at(i).seen;
+    return counts;
+}
+
+template <typename Tree>
+void SelectorEngine<Tree>::collectMultiFrom(const Node& node, const QVector<const ChainGroup*>& groups,
+                                            MultiState& state)
+{
+    // 1. 按桶剪枝
+    QVector<const ChainGroup*> kept;
+    kept.reserve(groups.size());
+    BloomFilter subtree;
+    bool haveBloom = false;
+    int visible = -1; // -1 未计算
+    for (const ChainGroup* g : groups) {
+        if (g->visibleOnly) {
+            if (visible < 0) visible = effectiveVisible(node) ? 1 : 0;
+            if (!visible) continue;
+        }
+        if (!g->typeKey.isEmpty()) {
+            if (!haveBloom) {
+                subtree = bloom(node);
+                haveBloom = true;
+            }
+            if (!subtree.mayContain(g->typeKey)) continue;
+        }
+        kept.append(g);
+    }
+    if (kept.isEmpty()) return;
+
+    // 2. 匹配当前节点
+    for (const ChainGroup* g : kept) {
+        const SelectorChain& sample = (*state.chains)[g->chains.first()];
+        if (!g->typeKey.isEmpty() && !tree_.matchType(node, sample.last().token)) continue;
+        for (int ci : g->chains) {
+            Window& w = state.windows[(*state.owners)[ci]];
+            if (w.full() || w.last == node) continue; // 已收满 / 同槽另一条分支已命中
+            if (!matches(node, (*state.chains)[ci])) continue;
+            w.hit(node);
+            if (w.full() && --state.pending == 0) return;
+        }
+    }
+
+    // 3. 下行；原子容器收窄链集合
+    if (!tree_.isAtomic(node)) {
+        for (const Node& child : tree_.children(node)) {
+            collectMultiFrom(child, kept, state);
+            if (state.pending == 0) return;
+        }
+        return;
+    }
+
+    std::vector<ChainGroup> narrowed;
+    narrowed.reserve(kept.size());
+    QVector<const ChainGroup*> next;
+    for (const ChainGroup* g : kept) {
+        ChainGroup reduced{ g->typeKey, g->visibleOnly, {} };
+        for (int ci : g->chains) {
+            if (tree_.descendInto(node, (*state.chains)[ci])) reduced.chains.append(ci);
+        }
+        if (reduced.chains.size() == g->chains.size()) {
+            next.append(g);
+        } else if (!reduced.chains.isEmpty()) {
+            narrowed.push_back(std::move(reduced));
+            next.append(&narrowed.back());
+        }
+    }
+    if (next.isEmpty()) return;
+    for (const Node& child : tree_.children(node)) {
+        collectMultiFrom(child, next, state);
+        if (state.pending == 0) return;
+    }
+}
+
+// ────────────────────────────────────────────────────────────────
+//  matchToken — 类型名 → 属性条件 → 伪类，任一层不满足即返回 false
+// ────────────────────────────────────────────────────────────────
+template <typename Tree>
+bool SelectorEngine<Tree>::matchToken(const Node& n, const SelectorToken& token) const
+{
+    if (!n) return false;
+
+    if (!token.typeKey.isEmpty() && !tree_.matchType(n, token))
+        return false;
+
+    for (const AttributeCondition& cond : token.attributes) {
+        if (!SelectorDetail::matchAttribute(tree_.attribute(n, cond.name), cond))
+            return false;
+    }
+
+    const ChildTable* siblings = nullptr; // 首个位置伪类出现时才定位
+    int selfIdx = -1;                     // 0-based
+    for (const PseudoClass& pc : token.pseudos) {
+        switch (pc.type) {
+        case PseudoClass::Visible:
+            if (!effectiveVisible(n)) return false;
+            break;
+        case PseudoClass::Enabled:
+            if (!tree_.isEnabled(n)) return false;
+            break;
+        case PseudoClass::Focused:
+            if (!tree_.hasFocus(n)) return false;
+            break;
+        case PseudoClass::Not:
+            for (const SelectorChain& sub : *pc.selectors) {
+                if (matches(n, sub)) return false;
+            }
+            break;
+        case PseudoClass::Has:
+            if (!hasRelative(n, pc)) return false;
+            break;
+        case PseudoClass::NthChild:
+        case PseudoClass::NthLastChild: {
+            if (!siblings && !(siblings = locate(n, &selfIdx))) return false;
+            const int pos = pc.type == PseudoClass::NthChild
+                          ? selfIdx + 1                          // 1-based 正向位置
+                          : siblings->nodes.size() - selfIdx;    // 1-based 反向位置
+            if (!pc.matchesPosition(pos)) return false;
+            break;
+        }
+        }
+    }
+    return true;
+}
+
+// ────────────────────────────────────────────────────────────────
+//  matchChainRTL — 从右向左回溯验证选择器链
+//
+//  n 已匹配 chain[idx+1]；连接 chain[idx] 与 chain[idx+1] 的组合器
+//  保存在 chain[idx+1].combinator（前导组合器）。
+//
+//  后代组合器写成沿父链的递推：
+//    rtl(n, idx) = (parent 匹配 chain[idx] 且 rtl(parent, idx-1))
+//                  || rtl(parent, idx)
+//  通用兄弟组合器同理沿前一个兄弟递推。两者的结果按 (节点, &chain[idx])
+//  记忆化，于是 "Item Item Item Button" 这类在深树上会对祖先组合
+//  指数级重试的选择器，总代价降为 O(深度 × 链长)。
+//  子 / 相邻组合器没有分支，不需要记忆化。
+// ────────────────────────────────────────────────────────────────
+template <typename Tree>
+bool SelectorEngine<Tree>::matchChainRTL(const Node& n, const SelectorChain& chain, int idx) const
+{
+    if (idx < 0) return true;
+
+    const SelectorToken& token = chain[idx].token;
+    const Combinator comb = chain[idx + 1].combinator;
+    switch (comb) {
+    case Combinator::Child: {
+        const Node p = tree_.parent(n);
+        return p && matchToken(p, token) && matchChainRTL(p, chain, idx - 1);
+    }
+    case Combinator::Adjacent: {
+        int i = -1;
+        const ChildTable* sibs = locate(n, &i);
+        if (!sibs || i == 0) return false;
+        const Node& prev = sibs->nodes.at(i - 1);
+        return matchToken(prev, token) && matchChainRTL(prev, chain, idx - 1);
+    }
+    case Combinator::Descendant:
+    case Combinator::Sibling:
+        break;
+    }
+
+    const MemoKey key(n, reinterpret_cast<quintptr>(&chain[idx]));
+    const auto cached = rtlCache_.constFind(key);
+    if (cached != rtlCache_.constEnd()) return cached.value();
+
+    Node next = Node();
+    if (comb == Combinator::Descendant) {
+        next = tree_.parent(n);
+    } else {
+        int i = -1;
+        const ChildTable* sibs = locate(n, &i);
+        if (sibs && i > 0) next = sibs->nodes.at(i - 1);
+    }
+
+    const bool result = next
+        && ((matchToken(next, token) && matchChainRTL(next, chain, idx - 1))
+            || matchChainRTL(next, chain, idx));
+    rtlCache_.insert(key, result);
+    return result;
+}
+
+// ────────────────────────────────────────────────────────────────
+//  bloom — 子树类型键的布隆过滤器，按节点缓存
+//
+//  collect 自顶向下逐层调用，不缓存时总代价为 O(n·深度)。
+// ────────────────────────────────────────────────────────────────
+template <typename Tree>
+BloomFilter SelectorEngine<Tree>::bloom(const Node& n)
+{
+    const auto cached = bloomCache_.constFind(n);
+    if (cached != bloomCache_.constEnd()) return cached.value();
+
+    BloomFilter bf;
+    tree_.addTypeKeys(n, bf);
+    for (const Node& child : tree_.children(n))
+        bf.merge(bloom(child));
+    bloomCache_.insert(n, bf);
+    return bf;
+}
+
+template <typename Tree>
+bool SelectorEngine<Tree>::matches(const Node& n, const SelectorChain& chain) const
+{
+    return !chain.isEmpty() && matchToken(n, chain.last().token)
+           && matchChainRTL(n, chain, chain.size() - 2);
+}
+
+// ────────────────────────────────────────────────────────────────
+//  childTable / locate — 查询内的子节点位置表
+//
+//  每个父节点只调用一次 declaredChildren() 并建立下标索引，
+//  之后同一父节点下所有候选的兄弟 / 位置判断都是 O(1)。
+//  Qt 5 的 QHash 节点地址稳定，返回的引用在 reset() 前有效。
+//
+//  n 不在父节点的声明子列表中时（例如组件内部声明的子项），
+//  不跨组件边界做兄弟判定。
+// ────────────────────────────────────────────────────────────────
+template <typename Tree>
+const typename SelectorEngine<Tree>::ChildTable&
+SelectorEngine<Tree>::childTable(const Node& parent) const
+{
+    auto it = childTables_.find(parent);
+    if (it == childTables_.end()) {
+        ChildTable table;
+        table.nodes = tree_.declaredChildren(parent);
+        table.index.reserve(table.nodes.size());
+        for (int i = 0; i < table.nodes.size(); ++i)
+            table.index.insert(table.nodes.at(i), i);
+        it = childTables_.insert(parent, table);
+    }
+    return it.value();
+}
+
+template <typename Tree>
+const typename SelectorEngine<Tree>::ChildTable*
+SelectorEngine<Tree>::locate(const Node& n, int* index) const
+{
+    const Node p = tree_.parent(n);
+    if (!p) return nullptr;
+    const ChildTable& table = childTable(p);
+    *index = table.index.value(n, -1);
+    return *index >= 0 ? &table : nullptr;
+}
+
+// ────────────────────────────────────────────────────────────────
+//  :has 求值
+//
+//  相对选择器自左向右求值：首段的组合器描述候选与锚点的关系，
+//  后续各段以上一段命中的节点为新锚点。
+//  后代搜索不受原子容器策略限制——锚点已经显式指定了组件。
+// ────────────────────────────────────────────────────────────────
+template <typename Tree>
+bool SelectorEngine<Tree>::hasRelative(const Node& anchor, const PseudoClass& pc) const
+{
+    const MemoKey key(anchor, quintptr(pc.selectors.get()));
+    const auto cached = hasCache_.constFind(key);
+    if (cached != hasCache_.constEnd()) return cached.value();
+
+    bool found = false;
+    for (const SelectorChain& rel : *pc.selectors) {
+        if (matchRelative(anchor, rel, 0)) {
+            found = true;
+            break;
+        }
+    }
+    hasCache_.insert(key, found);
+    return found;
+}
+
+template <typename Tree>
+bool SelectorEngine<Tree>::matchRelative(const Node& anchor, const SelectorChain& rel, int idx) const
+{
+    switch (rel[idx].combinator) {
+    case Combinator::Descendant:
+        return descendantMatches(anchor, rel, idx);
+    case Combinator::Child:
+        for (const Node& child : tree_.children(anchor)) {
+            if (relativeStep(child, rel, idx)) return true;
+        }
+        return false;
+    case Combinator::Adjacent: {
+        int i = -1;
+        const ChildTable* sibs = locate(anchor, &i);
+        return sibs && i + 1 < sibs->nodes.size() && relativeStep(sibs->nodes.at(i + 1), rel, idx);
+    }
+    case Combinator::Sibling: {
+        int i = -1;
+        const ChildTable* sibs = locate(anchor, &i);
+        for (int k = i + 1; sibs && k < sibs->nodes.size(); ++k) {
+            if (relativeStep(sibs->nodes.at(k), rel, idx)) return true;
+        }
+        return false;
+    }
+    }
+    return false;
+}
+
+// n 满足 rel[idx]，且（若还有右侧段）以 n 为锚点满足剩余各段
+template <typename Tree>
+bool SelectorEngine<Tree>::relativeStep(const Node& n, const SelectorChain& rel, int idx) const
+{
+    return matchToken(n, rel[idx].token)
+           && (idx + 1 >= rel.size() || matchRelative(n, rel, idx + 1));
+}
+
+// 结果只取决于 (anchor, idx)，按段地址记忆化：
+// 对嵌套的候选行逐个求 :has 时，内层子树只遍历一次
+template <typename Tree>
+bool SelectorEngine<Tree>::descendantMatches(const Node& anchor, const SelectorChain& rel, int idx) const
+{
+    const MemoKey key(anchor, quintptr(&rel[idx]));
+    const auto cached = descendantCache_.constFind(key);
+    if (cached != descendantCache_.constEnd()) return cached.value();
+
+    bool found = false;
+    for (const Node& child : tree_.children(anchor)) {
+        if (relativeStep(child, rel, idx) || descendantMatches(child, rel, idx)) {
+            found = true;
+            break;
+        }
+    }
+    descendantCache_.insert(key, found);
+    return found;
+}
+
+// ────────────────────────────────────────────────────────────────
+//  effectiveVisible — 自身可见且父节点有效可见
+//
+//  collectFrom 自顶向下访问，查询父节点时总能命中缓存，
+//  因此每个节点只做一次 isShown() 判定；RTL 回溯或兄弟判定
+//  访问到未遍历的节点时沿父链补算一次。
+// ────────────────────────────────────────────────────────────────
+template <typename Tree>
+bool SelectorEngine<Tree>::effectiveVisible(const Node& n) const
+{
+    const auto cached = visibleCache_.constFind(n);
+    if (cached != visibleCache_.constEnd()) return cached.value();
+
+    const Node p = tree_.parent(n);
+    const bool visible = tree_.isShown(n) && (!p || effectiveVisible(p));
+    visibleCache_.insert(n, visible);
+    return visible;
+}
+
+template <typename Tree>
+void SelectorEngine<Tree>::debugTree(const Node& n, int depth) const
+{
+    if (!n) return;
+    QObject* obj = Tree::object(n);
+    // 过滤 visible = false 的节点（及其整棵子树）
+    const QVariant vis = SelectorDetail::readProperty(obj, QStringLiteral("visible"));
+    if (vis.isValid() && !vis.toBool()) return;
+
+    const Node parent = tree_.parent(n);
+    LOG("Tree", QString(depth * 2, ' ') + tree_.typeLabel(n) +
+                "| type:" + obj->metaObject()->className() +
+                "| parent:" + (parent ? tree_.typeLabel(parent) : QStringLiteral("null")));
+    for (const Node& child : tree_.children(n))
+        debugTree(child, depth + 1);
+}
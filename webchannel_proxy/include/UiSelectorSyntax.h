@@ -0,0 +1,210 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <stdexcept>
+#include <bitset>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+
+#include <memory>
+
+// ════════════════════════════════════════════════════════════════
+//  选择器语法层：数据结构 + 解析器
+//
+//  与节点树无关，SelectorEngine<Tree>（UiSelectorEngine.h）
+//  对任意树类型复用同一份 SelectorChain。
+// ════════════════════════════════════════════════════════════════
+
+// ════════════════════════════════════════════════════════════════
+//  解析错误异常
+//  parseToken() 遇到语法错误时抛出，携带位置和原因信息。
+// ════════════════════════════════════════════════════════════════
+class SelectorParseError : public std::runtime_error {
+public:
+    explicit SelectorParseError(const QString& msg)
+        : std::runtime_error(msg.toStdString()) {}
+};
+
+// ════════════════════════════════════════════════════════════════
+//  1. 属性条件
+// ════════════════════════════════════════════════════════════════
+struct AttributeCondition {
+    QString name;   // 属性名，e.g. "placeholderText"
+    QString op;     // "=" | "~=" | "^=" | "$=" | "*=" | "|=" | ""(仅存在性)
+    QString value;  // 期望值
+};
+
+struct SelectorSegment;
+using SelectorChain = QList<SelectorSegment>;
+
+// ════════════════════════════════════════════════════════════════
+//  2. 伪类
+// ════════════════════════════════════════════════════════════════
+struct PseudoClass {
+    enum Type {
+        NthChild,       // :nth-child(an+b) / :first-child
+        NthLastChild,   // :nth-last-child(an+b) / :last-child
+        Visible,        // :visible  有效可见
+        Enabled,        // :enabled
+        Focused,        // :focused  持有活动焦点
+        Not,            // :not(selector_list)
+        Has             // :has(relative_selector_list)
+    };
+    Type type;
+    int  a;     // :nth-* 的 an+b 参数；纯位置时 a = 0，状态伪类均为 0
+    int  b;
+
+    // 1-based 位置 pos 是否满足 pos = a·k + b（k >= 0）
+    bool matchesPosition(int pos) const {
+        if (a == 0) return pos == b;
+        const int diff = pos - b;
+        return diff % a == 0 && diff / a >= 0;
+    }
+
+    // :not / :has 的参数。共享只读，指针在解析缓存存活期间稳定，
+    // 引擎以它作为 :has 记忆化的键。
+    std::shared_ptr<const QList<SelectorChain>> selectors;
+};
+
+// ════════════════════════════════════════════════════════════════
+//  3. 选择器 Token
+// ════════════════════════════════════════════════════════════════
+struct SelectorToken {
+    QString                   typeName;    // QML 类型名；空 = 通配符 *
+    QString                   typeKey;     // typeName 小写，类型匹配与布隆过滤器共用
+    QList<AttributeCondition> attributes;
+    QList<PseudoClass>        pseudos;
+};
+
+// ════════════════════════════════════════════════════════════════
+//  4. 组合器类型
+// ════════════════════════════════════════════════════════════════
+enum class Combinator {
+    Descendant, // ' '  后代
+    Child,      // '>'  直接子
+    Adjacent,   // '+'  紧邻前兄弟
+    Sibling     // '~'  任意前兄弟
+};
+
+// ════════════════════════════════════════════════════════════════
+//  5. 选择器段
+// ════════════════════════════════════════════════════════════════
+struct SelectorSegment {
+    SelectorToken token;
+    Combinator    combinator;
+};
+
+// ════════════════════════════════════════════════════════════════
+//  6. 布隆过滤器
+// ════════════════════════════════════════════════════════════════
+class BloomFilter {
+    static constexpr int BITS = 1024;
+    std::bitset<BITS> bits_;
+
+    int hash1(const QString& s) const {
+        uint h = 5381;
+        for (QChar c : s) h = ((h << 5) + h) ^ c.unicode();
+        return static_cast<int>(h % BITS);
+    }
+    int hash2(const QString& s) const {
+        uint h = 0;
+        for (QChar c : s) h = h * 31 + c.unicode();
+        return static_cast<int>((h ^ (h >> 16)) % BITS);
+    }
+
+public:
+    void add(const QString& s)             { bits_.set(hash1(s)); bits_.set(hash2(s)); }
+    bool mayContain(const QString& s) const{ return bits_.test(hash1(s)) && bits_.test(hash2(s)); }
+    void merge(const BloomFilter& o)       { bits_ |= o.bits_; }
+};
+
+// ════════════════════════════════════════════════════════════════
+//  7. 解析器
+//
+//  手写递归下降，解析失败抛 SelectorParseError。
+//  parse() 只处理单条选择器（顶层逗号由调用方通过 splitSelectorList 拆分），
+//  结果按选择器字符串缓存。
+// ════════════════════════════════════════════════════════════════
+class SelectorParser {
+public:
+    SelectorChain parse(const QString& selector);
+
+    // 调试：返回解析后的 SelectorChain 的可读文本（仅供测试）
+    QString debugParse(const QString& selector);
+
+    void clearCache() { cache_.clear(); }
+
+private:
+    SelectorChain parseChain       (const QString& selector, bool relative);
+    SelectorToken parseToken       (const QString& src, int& pos);
+    void          parseAttrSelector(const QString& src, int& pos, SelectorToken& token);
+    void          parsePseudoClass (const QString& src, int& pos, SelectorToken& token);
+    QString       parseIdent       (const QString& src, int& pos);
+    QString       parseAttrValue   (const QString& src, int& pos);
+    QString       parseAttrOp      (const QString& src, int& pos);
+    int           parseInteger     (const QString& src, int& pos);
+    void          parseNth         (const QString& arg, PseudoClass& pc);
+    QString       parseParenthesized(const QString& src, int& pos);
+    void          skipSpaces       (const QString& src, int& pos);
+    void          expect           (const QString& src, int& pos, QChar ch);
+
+    QHash<QString, SelectorChain> cache_;
+};
+
+// 将顶层逗号分隔的复合选择器拆分为子选择器列表（跳过 [...] 内部的逗号）
+QStringList splitSelectorList(const QString& selector);
+
+// ════════════════════════════════════════════════════════════════
+//  8. 选择器依赖
+//
+//  匹配结果可能受哪些属性影响：属性条件里的属性名，以及状态伪类
+//  对应的属性（:visible → visible，:enabled → enabled，
+//  :focused → activeFocus），递归包含 :not / :has 的参数。
+//  含 :has 时任意后代的变化都可能改变祖先的匹配结果，relative 置位。
+//  活动查询与结果缓存据此决定要监听哪些变化通知。
+// ════════════════════════════════════════════════════════════════
+struct SelectorDependencies {
+    QSet<QString> properties;
+    bool          relative = false;
+};
+
+void collectDependencies(const SelectorChain& chain, SelectorDependencies& deps);
+
+
+inline void log(const char *tag, const QString &msg)
+{
+    // 1. C++11 保证了 static 局部变量在多线程环境下只会被初始化一次。
+    // 这在纯头文件中是替代 Q_GLOBAL_STATIC 的最安全做法。
+    static QMutex mutex;
+
+    // 静态文件指针：只会在第一次执行时初始化
+    static struct LogFile {
+        QFile file;
+        QTextStream stream;
+        LogFile() {
+            file.setFileName(QStringLiteral("debug.log"));
+            if (file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+                stream.setDevice(&file);
+            }
+        }
+        ~LogFile() {
+            if (file.isOpen()) file.close();
+        }
+    } logStorage;
+
+    if (logStorage.file.isOpen()) {
+        logStorage.stream << QDateTime::currentDateTime().toString(Qt::ISODateWithMs)
+                          << " [" << tag << "] " << msg << "\n";
+        // 强制刷新缓冲区，确保实时写入磁盘
+        logStorage.stream.flush();
+    }
+}
+
+#define LOG(tag, msg) log(tag, msg)
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "UiTreeWatcher.h"
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+
+#include <atomic>
+
+class QQuickWindow;
+class UiRenderThrottle;
+
+// ════════════════════════════════════════════════════════════════
+//  UiSettleMonitor — 界面静止检测（wait_idle / 动作的 settle 模式）
+//
+//  静止条件（同时满足并持续 quietMs）：
+//    · 没有运行中的动画：QAbstractAnimation 处于 Running，或 QML 的
+//      Animation / Animator / Transition 的 running 为 true
+//    · 没有正在加载的 Loader（status == Loader.Loading）
+//    · 监听的 QQuickWindow 在 quietMs 内没有交换过帧
+//    · 没有待处理的 polish
+//  polish 随窗口的 UpdateRequest 在渲染前执行，通常表现为一次帧交换。
+//  两种情况下不会渲染，单独检查：
+//    · 渲染节流拦下了 UpdateRequest：每轮先 flush() 补发
+//    · 窗口未曝光（隐藏 / 最小化 / 离屏）：渲染循环收到 UpdateRequest
+//      后跳过 polish，窗口记为待处理，直到再次曝光；期间报告 "polish"
+//
+//  动画 / Loader 对象由内部的 UiTreeWatcher 在纳入监听时分类记录，
+//  每轮检查只看这两类对象，不遍历整棵树。frameSwapped 在渲染线程
+//  发出，直接连接并以原子量记录时间。
+//
+//  等待期间每轮最多处理 kPollMs 的事件；超过 timeoutMs 仍未静止时返回
+//  idle = false 与尚未满足的条件，不视为错误。
+// ════════════════════════════════════════════════════════════════
+class UiSettleMonitor : public QObject {
+    Q_OBJECT
+
+public:
+    struct Options {
+        int quietMs = 100;
+        int timeoutMs = 5000;
+    };
+
+    explicit UiSettleMonitor(QObject* parent = nullptr);
+    ~UiSettleMonitor() override;
+
+    // {quietMs, timeoutMs}，缺省项取默认值
+    static Options options(const QJsonObject& json);
+
+    // 等待 roots 下的界面静止；throttle 非空时补发其拦下的更新。
+    // 返回 {idle, elapsedMs, frames[, pending]}
+    QJsonObject wait(const QList<QObject*>& roots, const Options& options,
+                     UiRenderThrottle* throttle = nullptr);
+
+    static const int kPollMs = 10;
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    void onAttached(QObject* obj);
+    void onObjectDestroyed(QObject* obj);
+
+    void refresh(const QList<QObject*>& roots);
+    void addWindow(QQuickWindow* window);
+    // 当前未满足的条件："animations" / "loading" / "polish"
+    QStringList busy();
+
+    UiTreeWatcher           watcher_;
+    QSet<QObject*>          roots_;
+    QSet<QObject*>          animations_;
+    QSet<QObject*>          loaders_;
+    QSet<QObject*>          windows_;   // 已连接 frameSwapped 的窗口
+    QSet<QQuickWindow*>     unrendered_;  // 未曝光时收到过 UpdateRequest
+
+    QElapsedTimer           clock_;
+    std::atomic<qint64>     lastFrame_{ -1 };  // clock_ 上最后一次交换帧的时刻
+    std::atomic<int>        frames_{ 0 };
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "UiTreeWatcher.h"
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+// ════════════════════════════════════════════════════════════════
+//  UiTextIndex — 文本属性索引（text / title / placeholderText 等）
+//
+//  "text" / "title" 目标不再每次 findChildren + 逐个 property()：
+//    · 精确匹配：值 → 对象的哈希（区分大小写 / 按 toCaseFolded 折叠各一份）
+//    · 包含匹配：折叠后的三元组（trigram）倒排表，取查询各三元组
+//      倒排集合的交集作为候选；不足三个字符的查询逐条比对已索引的值
+//    · 候选最后重读一次属性确认，并要求仍位于查询根之下
+//
+//  维护：内部的 UiTreeWatcher 监听子树结构与这些属性的 notify 信号 /
+//  动态属性变更，逐对象重建索引项；新子树在查询前 sync() 纳入。
+//  没有 notify 信号的属性（如 QLabel::text、QAbstractButton::text）
+//  无法感知，持有它们的对象记为易变对象，每次查询（含带超时查找的
+//  每轮轮询）前重读。已知限制：QWidget 界面的文本大多属于这一类，
+//  Qt 也没有可靠的替代通知（setText 不是虚函数，无障碍 NameChanged
+//  只在辅助技术激活时发送），所以控件处理器的文本查找仍与这类控件的
+//  数量成正比——省掉的是树遍历与其他对象的读取，不是这部分重读。
+//  新子树的纳入只遍历新增部分（见 UiTreeWatcher::sync）。
+//
+//  命中顺序与原线性查找一致：只认 QObject 后代，按 findChildren() 的
+//  顺序（QObject 树先序）排列，查询根自身排在其后代之后；
+//  setIncludeRoots(false) 时根自身不参与匹配（控件处理器原先如此）。
+// ════════════════════════════════════════════════════════════════
+class UiTextIndex : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Match { Exact, Contains };
+
+    explicit UiTextIndex(const QStringList& properties, QObject* parent = nullptr);
+    ~UiTextIndex() override;
+
+    // roots 下（includeRoots 时含 roots 自身）任一属性匹配 value 的首个对象；未命中返回 nullptr
+    QObject* find(const QList<QObject*>& roots, const QString& value,
+                  Match match = Match::Exact, Qt::CaseSensitivity cs = Qt::CaseSensitive);
+    // 同上，返回全部命中（文档顺序）
+    QList<QObject*> findAll(const QList<QObject*>& roots, const QString& value,
+                            Match match = Match::Exact, Qt::CaseSensitivity cs = Qt::CaseSensitive);
+
+    // 查询根自身是否参与匹配，默认参与
+    void setIncludeRoots(bool include) { includeRoots_ = include; }
+
+    const QStringList& properties() const { return properties_; }
+    int size() const { return values_.size(); }
+
+    static const int kGramSize = 3;
+
+private:
+    void onAttached(QObject* obj);
+    void onPropertyChanged(QObject* obj);
+    void onObjectDestroyed(QObject* obj);
+
+    // 查询前：纳入新根 / 新子树，重读易变对象
+    void refresh(const QList<QObject*>& roots);
+    QStringList read(QObject* obj) const;
+    void reindex(QObject* obj);
+    void insert(QObject* obj, const QStringList& values);
+    void erase(QObject* obj);
+    QSet<QObject*> candidates(const QString& value, Match match, Qt::CaseSensitivity cs) const;
+    bool matches(QObject* obj, const QString& value, Match match, Qt::CaseSensitivity cs) const;
+
+    static QSet<QString> grams(const QString& folded);
+
+    QStringList                     properties_;
+    UiTreeWatcher                   watcher_;
+    QSet<QObject*>                  roots_;      // 已 watch 的根
+    QSet<QObject*>                  volatile_;   // 有属性无 notify 信号的对象
+    bool                            includeRoots_ = true;
+
+    QHash<QObject*, QStringList>    values_;     // 对象 → 各属性的当前值（与 properties_ 对齐）
+    QHash<QString, QSet<QObject*>>  exact_;
+    QHash<QString, QSet<QObject*>>  folded_;
+    QHash<QString, QSet<QObject*>>  grams_;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMetaMethod>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+// ════════════════════════════════════════════════════════════════
+//  UiTreeWatcher — 对象树变化监听
+//
+//  只监听 watch() 过的子树，变化来源：
+//    · 结构：QObject 子对象增删（ChildAdded / ChildRemoved 事件）；
+//      QQuickItem 可视子项增删（childrenChanged）
+//    · 属性：addProperties() 登记的属性的 notify 信号；
+//      QWidget 的 Show / Hide / EnabledChange / FocusIn / FocusOut 事件；
+//      登记属性的动态属性变更（DynamicPropertyChange）
+//
+//  每次变化同步递增 generation()，查询结果缓存据此判定失效；
+//  变化点在下一轮事件循环合并为一次 changed(scopes) 通知，
+//  scope 为受影响子树的根：
+//    结构变化 → 子节点集合变化的父节点
+//    属性变化 → 对象的父节点（兄弟组合器、后代组合器都可能受影响）
+//  新加入的子树在合并通知前自动纳入监听：ChildAdded 只遍历新子对象，
+//  childrenChanged 只检查该 Item 的直接可视子项，不重走父节点的整棵子树。
+//
+//  没有 notify 信号的属性无法感知：按 (对象, 属性) 记录（同时递增
+//  generation），isObservable(name, root) 只在 root 子树内仍有这类对象时
+//  返回 false；对象销毁后自动移除。QWidget 的 visible / enabled 由事件覆盖，不算在内。
+//
+//  事件来源是进程内共享的一个应用级事件过滤器（首次 watch() 时安装），
+//  按对象分发给监听它的各个 watcher；每个事件只经过一次过滤与一次查表。
+// ════════════════════════════════════════════════════════════════
+class UiTreeWatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit UiTreeWatcher(QObject* parent = nullptr);
+    ~UiTreeWatcher() override;
+
+    // 将 root 子树（QObject 子对象 + QQuickItem 可视子项）纳入监听
+    void watch(QObject* root);
+    bool isWatched(QObject* obj) const { return known_.contains(obj); }
+
+    // 追加需要监听 notify 信号的属性，已纳入监听的对象补连新属性
+    void addProperties(const QSet<QString>& names);
+    // root 子树内是否所有对象的 name 属性都能感知变化
+    bool isObservable(const QString& name, QObject* root) const;
+
+    // 立即把结构变化后新出现的子树纳入监听（不发 changed）。
+    // 同步查询前调用，避免在合并通知之前遍历到尚未监听的节点。
+    void sync();
+
+    // 任一被监听的变化都会使其递增
+    quint64 generation() const { return generation_; }
+
+    // 结构 / 属性上的逻辑父节点：QQuickItem 取 parentItem()，其余取 parent()
+    static QObject* logicalParent(QObject* obj);
+    // node 是否位于 scope 子树内（含 scope 自身）
+    static bool isWithin(QObject* node, QObject* scope);
+
+signals:
+    void changed(const QList<QObject*>& scopes);
+    // 逐对象的同步通知：节点纳入监听（元对象已完整）、登记属性变化
+    void attached(QObject* obj);
+    void propertyChanged(QObject* obj);
+
+private slots:
+    void onItemChildrenChanged();
+    void onPropertyNotify();
+    void onDestroyed(QObject* obj);
+
+private:
+    friend class UiTreeWatcherHub;
+
+    // 共享过滤器分发来的事件；watched 一定是已监听的对象
+    void handleEvent(QObject* watched, QEvent* event);
+    // 遍历新出现的子树，遇到已监听的节点即停止
+    void watchNew(QObject* obj);
+    void attach(QObject* obj);
+    void connectProperties(QObject* obj, const QSet<QString>& names);
+    void markStructure(QObject* parent, QObject* added = nullptr);
+    void markProperty(QObject* obj);
+    void queueFlush();
+    void flush();
+
+    QSet<QObject*> known_;
+    QSet<QString>  properties_;
+    QHash<QString, QSet<QObject*>> unobservable_;  // 属性 → 该属性无 notify 信号的对象
+    QSet<QObject*> dirty_;            // 待通知的 scope
+    QVector<QPointer<QObject>> pendingChildren_;  // ChildAdded 的新子对象（可能在合并前销毁）
+    QSet<QObject*> pendingItems_;     // 可视子项变化的 Item，合并时检查其直接子项
+    QMetaMethod    notifySlot_;
+    quint64        generation_ = 0;
+    bool           flushQueued_ = false;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+class QObject;
+struct QMetaObject;
+
+// ════════════════════════════════════════════════════════════════
+//  UiTypeSchema — 按类名缓存的类型描述（describe_type）
+//
+//  describe() 输出：
+//    {className, qmlName, inherits: [父类链], properties: [...], methods: [...]}
+//    property  {name, type, readable, writable, notify, owner}
+//    method    {name, signature, kind: signal|slot|method, returnType,
+//               parameterTypes, parameterNames, owner}
+//  包含继承来的成员（owner 为声明它的类），方法只列 public。
+//  QML 组件类型（_QMLTYPE_ / _QML_ 后缀）同样适用，qmlName 为还原后的组件名。
+//
+//  按类名查找：每次重新解析——QMetaType 注册的 "Class*" →
+//  在给定根下按 className / qmlName 找一个实例取其元对象。
+//
+//  缓存只保存生成好的 JSON，以类名为键，不跨调用保留元对象指针：
+//  声明了成员的 QML 对象各有一份随对象释放的元对象，
+//  指针在下一次调用时可能已经悬空。缓存项记录 propertyCount /
+//  methodCount，与当前元对象不一致时重新生成。
+// ════════════════════════════════════════════════════════════════
+class UiTypeSchema {
+public:
+    QJsonObject describe(const QMetaObject* mo);
+    // 按 className / qmlName 解析并描述；找不到时返回空对象
+    QJsonObject describe(const QString& className, const QList<QObject*>& roots);
+
+    int size() const { return cache_.size(); }
+
+private:
+    struct Entry {
+        int         propertyCount = -1;
+        int         methodCount = -1;
+        QJsonObject schema;
+    };
+
+    static QJsonObject        build(const QMetaObject* mo);
+    static bool               matchesName(const QMetaObject* mo, const QString& name);
+    static const QMetaObject* find(const QString& className, const QList<QObject*>& roots);
+
+    QHash<QString, Entry> cache_;   // 类名 → 描述
+};
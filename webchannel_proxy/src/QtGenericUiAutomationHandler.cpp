@@ -1,4 +1,12 @@
 #include "UiAutomationProxyServer.h"
+#include "UiActionRegistry.h"
+#include "UiMethodCache.h"
+#include "UiPropertyReader.h"
+#include "UiQMLQuery.h"
+#include "UiRenderThrottle.h"
+#include "UiSettleMonitor.h"
+#include "UiTextIndex.h"
+#include "UiTypeSchema.h"
 
 #include <QAbstractButton>
 #include <QAbstractItemModel>
@@ -11,6 +19,7 @@
 #include <QLineEdit>
 #include <QListWidget>
 #include <QMetaObject>
+#include <QMetaProperty>
 #include <QPointer>
 #include <QQuickItem>
 #include <QQuickWindow>
@@ -34,37 +43,74 @@ bool invokeNoArgs(QObject *obj, const char *method) {
     if (!obj) {
         return false;
     }
-    return QMetaObject::invokeMethod(obj, method, Qt::DirectConnection);
+    const QMetaMethod m = UiMethodCache::bySignature(obj->metaObject(), QByteArray(method) + "()");
+    return m.isValid() && m.invoke(obj, Qt::DirectConnection);
 }
 
 bool invokeSetInt(QObject *obj, const char *method, int value) {
     if (!obj) {
         return false;
     }
-    return QMetaObject::invokeMethod(obj, method, Qt::DirectConnection, Q_ARG(int, value));
+    const QMetaMethod m = UiMethodCache::bySignature(obj->metaObject(), QByteArray(method) + "(int)");
+    return m.isValid() && m.invoke(obj, Qt::DirectConnection, Q_ARG(int, value));
 }
 
 bool invokeSetBool(QObject *obj, const char *method, bool value) {
     if (!obj) {
         return false;
     }
-    return QMetaObject::invokeMethod(obj, method, Qt::DirectConnection, Q_ARG(bool, value));
+    const QMetaMethod m = UiMethodCache::bySignature(obj->metaObject(), QByteArray(method) + "(bool)");
+    return m.isValid() && m.invoke(obj, Qt::DirectConnection, Q_ARG(bool, value));
 }
 
 bool invokeSetString(QObject *obj, const char *method, const QString &value) {
     if (!obj) {
         return false;
     }
-    return QMetaObject::invokeMethod(obj, method, Qt::DirectConnection, Q_ARG(QString, value));
+    const QMetaMethod m = UiMethodCache::bySignature(obj->metaObject(), QByteArray(method) + "(QString)");
+    return m.isValid() && m.invoke(obj, Qt::DirectConnection, Q_ARG(QString, value));
 }
 
 QJsonValue toJson(const QVariant &value) {
     return QJsonValue::fromVariant(value);
 }
+
+QJsonObject describeTarget(QObject *obj) {
+    QJsonObject out;
+    out.insert(QStringLiteral("objectName"), obj->objectName());
+    out.insert(QStringLiteral("className"), QString::fromUtf8(obj->metaObject()->className()));
+    const QVariant text = obj->property("text");
+    if (text.isValid()) {
+        out.insert(QStringLiteral("text"), toJson(text));
+    }
+    const QVariant title = obj->property("title");
+    if (title.isValid()) {
+        out.insert(QStringLiteral("title"), toJson(title));
+    }
+    const QVariant visible = obj->property("visible");
+    if (visible.isValid()) {
+        out.insert(QStringLiteral("visible"), visible.toBool());
+    }
+    return out;
+}
 }  // namespace
 
 QtGenericUiAutomationHandler::QtGenericUiAutomationHandler(QObject *rootObject)
-    : m_root(rootObject) {}
+    : m_root(rootObject), m_selector(std::make_unique<QmlQuerySelector>()),
+      m_textIndex(std::make_unique<UiTextIndex>(
+          QStringList{QStringLiteral("text"), QStringLiteral("title"), QStringLiteral("windowTitle")})),
+      m_propertyReader(std::make_unique<UiPropertyReader>()),
+      m_typeSchema(std::make_unique<UiTypeSchema>()),
+      m_actions(std::make_unique<UiActionRegistry>()),
+      m_settle(std::make_unique<UiSettleMonitor>()),
+      m_render(std::make_unique<UiRenderThrottle>()) {
+    m_selector->setResultCacheCapacity(kSelectorCacheCapacity);
+    // 文本查找原先只扫描根的 findChildren()，根窗口的标题不参与
+    m_textIndex->setIncludeRoots(false);
+    registerBuiltinActions();
+}
+
+QtGenericUiAutomationHandler::~QtGenericUiAutomationHandler() = default;
 
 void QtGenericUiAutomationHandler::setRootObject(QObject *rootObject) {
     m_root = rootObject;
@@ -79,21 +125,171 @@ QJsonValue QtGenericUiAutomationHandler::resolve(const QJsonObject &target, QStr
     if (!obj) {
         return {};
     }
+    return describeTarget(obj);
+}
+
+QJsonValue QtGenericUiAutomationHandler::resolve(const QJsonObject &target, const QStringList &fields, QString *error) {
+    if (fields.isEmpty()) {
+        return resolve(target, error);
+    }
+    QObject *obj = findTarget(target, error);
+    if (!obj) {
+        return {};
+    }
+    return m_propertyReader->project(obj, fields);
+}
+
+// selector 目标合并为一次 querySelectorMulti 遍历，其余目标逐个 findTarget
+QVector<QObject *> QtGenericUiAutomationHandler::findTargets(QObject *root, const QJsonArray &targets,
+                                                             QVector<QString> *errors) const {
+    QVector<QObject *> found(targets.size(), nullptr);
+    errors->fill(QString(), targets.size());
+    QStringList selectors;
+    QVector<int> selectorSlots;
+    bool debug = false;
+    for (int i = 0; i < targets.size(); ++i) {
+        const QJsonObject target = targets.at(i).toObject();
+        const QString kind = target.value(QStringLiteral("kind")).toString().trimmed().toLower();
+        const QString value = target.value(QStringLiteral("value")).toString().trimmed();
+        if (kind == QStringLiteral("selector") && !value.isEmpty()) {
+            selectors.append(value);
+            selectorSlots.append(i);
+            debug = debug || target.value(QStringLiteral("debug")).toBool();
+            continue;
+        }
+        found[i] = findTarget(target, &(*errors)[i]);
+    }
+
+    if (!selectors.isEmpty()) {
+        QStringList batchErrors;
+        const auto results = m_selector->querySelectorMulti(root, selectors, &batchErrors, true, debug);
+        for (int j = 0; j < selectors.size(); ++j) {
+            if (!results.at(j).isEmpty()) {
+                found[selectorSlots.at(j)] = results.at(j).first();
+            } else {
+                (*errors)[selectorSlots.at(j)] =
+                    QStringLiteral("target not found by selector %1: %2").arg(selectors.at(j)).arg(batchErrors.at(j));
+            }
+        }
+    }
+    return found;
+}
+
+QJsonValue QtGenericUiAutomationHandler::resolveMany(const QJsonArray &targets, QString *error) {
+    QObject *root = rootRequired(error);
+    if (!root) {
+        return {};
+    }
+
+    QVector<QString> errors;
+    const QVector<QObject *> found = findTargets(root, targets, &errors);
+    QJsonArray out;
+    for (int i = 0; i < found.size(); ++i) {
+        out.append(found.at(i) ? resolveManyEntry(describeTarget(found.at(i)), QString())
+                               : resolveManyEntry(QJsonValue(), errors.at(i)));
+    }
+    return out;
+}
+
+QJsonValue QtGenericUiAutomationHandler::readProperties(const QJsonArray &targets, const QJsonObject &selector,
+                                                        const QStringList &properties, QString *error) {
+    QObject *root = rootRequired(error);
+    if (!root) {
+        return {};
+    }
+
+    QVector<QObject *> objects;
+    QVector<QString> errors;
+    if (!selector.isEmpty()) {
+        const QString kind = selector.value(QStringLiteral("kind")).toString().trimmed().toLower();
+        if (kind != QStringLiteral("selector")) {
+            asError(QStringLiteral("read_properties target must be a selector"), error);
+            return {};
+        }
+        QString err;
+        const auto objs = m_selector->querySelectorAll(root, selector.value(QStringLiteral("value")).toString().trimmed(),
+                                                       SelectorRange(), &err, selector.value(QStringLiteral("debug")).toBool());
+        if (!err.isEmpty()) {
+            asError(err, error);
+            return {};
+        }
+        objects = objs.toVector();
+    } else {
+        objects = findTargets(root, targets, &errors);
+    }
+    return propertyTable(*m_propertyReader, objects, errors, properties);
+}
+
+QJsonValue QtGenericUiAutomationHandler::selectorCacheStats(QString *error) {
+    Q_UNUSED(error)
+    return selectorCacheStatsJson(*m_selector);
+}
+
+std::shared_ptr<const UiSceneSnapshot> QtGenericUiAutomationHandler::captureSnapshot(const QSet<QString> &properties, QString *error) {
+    auto snapshot = m_selector->snapshot(searchRoots(), properties);
+    if (!snapshot) {
+        asError(QStringLiteral("root object is not configured"), error);
+    }
+    return snapshot;
+}
+
+QJsonValue QtGenericUiAutomationHandler::describeType(const QJsonObject &target, const QString &className, QString *error) {
+    QObject *obj = nullptr;
+    if (!target.isEmpty()) {
+        obj = findTarget(target, error);
+        if (!obj) {
+            return {};
+        }
+    }
+    return describeTypeOf(*m_typeSchema, obj, className, searchRoots(), error);
+}
+
+QList<QObject *> QtGenericUiAutomationHandler::searchRoots() const {
+    return m_root ? QList<QObject *>{m_root} : QList<QObject *>();
+}
+
+QStringList QtGenericUiAutomationHandler::textProperties() const {
+    return m_textIndex->properties();
+}
+
+QJsonValue QtGenericUiAutomationHandler::queryAll(const QJsonObject &target, int offset, int limit, bool countOnly, QString *error) {
+    QObject *root = rootRequired(error);
+    if (!root) {
+        return {};
+    }
+    const QString kind = target.value(QStringLiteral("kind")).toString().trimmed().toLower();
+    const QString value = target.value(QStringLiteral("value")).toString().trimmed();
+    if (kind != QStringLiteral("selector")) {
+        asError(QStringLiteral("query_all requires a selector target"), error);
+        return {};
+    }
+
+    SelectorRange range;
+    range.offset = offset;
+    range.limit = limit;
+    QString err;
     QJsonObject out;
-    out.insert(QStringLiteral("objectName"), obj->objectName());
-    out.insert(QStringLiteral("className"), QString::fromUtf8(obj->metaObject()->className()));
-    const QVariant text = obj->property("text");
-    if (text.isValid()) {
-        out.insert(QStringLiteral("text"), toJson(text));
+    if (countOnly) {
+        const int count = m_selector->countSelectorAll(root, value, range, &err);
+        if (!err.isEmpty()) {
+            asError(err, error);
+            return {};
+        }
+        out.insert(QStringLiteral("count"), count);
+        return out;
     }
-    const QVariant title = obj->property("title");
-    if (title.isValid()) {
-        out.insert(QStringLiteral("title"), toJson(title));
+
+    const auto objs = m_selector->querySelectorAll(root, value, range, &err, target.value(QStringLiteral("debug")).toBool());
+    if (!err.isEmpty()) {
+        asError(err, error);
+        return {};
     }
-    const QVariant visible = obj->property("visible");
-    if (visible.isValid()) {
-        out.insert(QStringLiteral("visible"), visible.toBool());
+    QJsonArray items;
+    for (QObject *obj : objs) {
+        items.append(describeTarget(obj));
     }
+    out.insert(QStringLiteral("count"), items.size());
+    out.insert(QStringLiteral("items"), items);
     return out;
 }
 
@@ -107,9 +303,13 @@ QJsonValue QtGenericUiAutomationHandler::executeAction(
         return {};
     }
 
-    const QString op = action.trimmed().toLower();
+    const UiActionRegistry::Action *entry = m_actions->find(action);
+    if (!entry) {
+        asError(QStringLiteral("unsupported action: %1").arg(action), error);
+        return {};
+    }
     QObject *obj = nullptr;
-    if (op == QStringLiteral("close_page") && target.isEmpty()) {
+    if ((entry->flags & UiActionRegistry::RootIfNoTarget) && target.isEmpty()) {
         obj = root;
     } else {
         obj = findTarget(target, error);
@@ -118,81 +318,166 @@ QJsonValue QtGenericUiAutomationHandler::executeAction(
         }
     }
 
-    if (op == QStringLiteral("click")) {
+    QString err;
+    const QJsonValue result = entry->handler(obj, value, &err);
+    if (!err.isEmpty()) {
+        asError(err, error);
+        return {};
+    }
+    if (!(entry->flags & UiActionRegistry::NoSettle)) {
+        QCoreApplication::processEvents();
+    }
+    return result;
+}
+
+// 内置动作；失败信息与原分支链一致
+void QtGenericUiAutomationHandler::registerBuiltinActions() {
+    UiActionRegistry &actions = *m_actions;
+    actions.add(QStringLiteral("click"), [this](QObject *obj, const QJsonValue &, QString *error) -> QJsonValue {
         if (!clickObject(obj)) {
             asError(QStringLiteral("click not supported by target"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("input")) {
+        return {};
+    });
+    actions.add(QStringLiteral("input"), [this](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         if (!setTextValue(obj, value.toString())) {
             asError(QStringLiteral("input requires a text-capable target"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("upload")) {
+        return {};
+    });
+    actions.add(QStringLiteral("upload"), [this](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         const QString abs = QFileInfo(value.toString()).absoluteFilePath();
         if (!setTextValue(obj, abs)) {
             asError(QStringLiteral("upload requires a text-capable target"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("select")) {
+        return {};
+    });
+    actions.add(QStringLiteral("select"), [this](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         if (!setCurrentText(obj, value.toString())) {
             asError(QStringLiteral("select requires currentText/currentIndex support"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("switch_page")) {
+        return {};
+    });
+    actions.add(QStringLiteral("switch_page"), [this](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         if (value.isDouble()) {
             if (!setCurrentIndex(obj, value.toInt())) {
                 asError(QStringLiteral("switch_page(index) not supported"), error);
-                return {};
             }
-        } else {
-            const QString raw = value.toString();
-            bool isInt = false;
-            const int idx = raw.toInt(&isInt);
-            if (isInt) {
-                if (!setCurrentIndex(obj, idx)) {
-                    asError(QStringLiteral("switch_page(index) not supported"), error);
-                    return {};
-                }
-            } else if (!setCurrentText(obj, raw)) {
-                asError(QStringLiteral("switch_page(text) not supported"), error);
-                return {};
+            return {};
+        }
+        const QString raw = value.toString();
+        bool isInt = false;
+        const int idx = raw.toInt(&isInt);
+        if (isInt) {
+            if (!setCurrentIndex(obj, idx)) {
+                asError(QStringLiteral("switch_page(index) not supported"), error);
             }
+        } else if (!setCurrentText(obj, raw)) {
+            asError(QStringLiteral("switch_page(text) not supported"), error);
         }
-    } else if (op == QStringLiteral("slide")) {
+        return {};
+    });
+    actions.add(QStringLiteral("slide"), [](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         if (auto *slider = qobject_cast<QSlider *>(obj)) {
             slider->setValue(value.toInt());
         } else if (!obj->setProperty("value", value.toVariant())) {
             asError(QStringLiteral("slide requires slider/value target"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("toggle")) {
+        return {};
+    });
+    actions.add(QStringLiteral("toggle"), [this](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         if (value.isBool()) {
             if (!setChecked(obj, value.toBool())) {
                 asError(QStringLiteral("toggle(bool) not supported"), error);
-                return {};
             }
         } else if (!clickObject(obj)) {
             asError(QStringLiteral("toggle requires click or checked support"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("single_select")) {
+        return {};
+    });
+    actions.add(QStringLiteral("single_select"), [this](QObject *obj, const QJsonValue &, QString *error) -> QJsonValue {
         if (!setChecked(obj, true) && !clickObject(obj)) {
             asError(QStringLiteral("single_select not supported"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("close_page")) {
+        return {};
+    });
+    actions.add(QStringLiteral("close_page"), [this](QObject *obj, const QJsonValue &, QString *error) -> QJsonValue {
         if (!closeObject(obj)) {
             asError(QStringLiteral("close_page not supported"), error);
-            return {};
         }
-    } else {
-        asError(QStringLiteral("unsupported action: %1").arg(action), error);
         return {};
+    }, UiActionRegistry::RootIfNoTarget);
+}
+
+QJsonValue QtGenericUiAutomationHandler::apply(const QJsonArray &updates, QString *error) {
+    QObject *root = rootRequired(error);
+    if (!root) {
+        return {};
+    }
+
+    QJsonArray targets;
+    for (const QJsonValue &update : updates) {
+        targets.append(update.toObject().value(QStringLiteral("target")));
+    }
+    QVector<QString> errors;
+    const QVector<QObject *> found = findTargets(root, targets, &errors);
+
+    const auto write = [this](QObject *obj, const QString &property, const QVariant &value) {
+        return writeProperty(obj, property, value);
+    };
+    int applied = 0;
+    QJsonArray failed;
+    for (int i = 0; i < updates.size(); ++i) {
+        QString err = errors.at(i);
+        if (found.at(i)) {
+            applyOne(*m_actions, found.at(i), updates.at(i).toObject(), write, &err);
+        } else if (err.isEmpty()) {
+            err = QStringLiteral("target not found");
+        }
+        if (err.isEmpty()) {
+            ++applied;
+            continue;
+        }
+        QJsonObject failure;
+        failure.insert(QStringLiteral("index"), i);
+        failure.insert(QStringLiteral("error"), err);
+        failed.append(failure);
     }
 
+    // 所有更新写完之后只处理一次事件：期间投递的 LayoutRequest / UpdateRequest /
+    // polish 已合并，布局与渲染只跑一轮
     QCoreApplication::processEvents();
-    return {};
+
+    QJsonObject out;
+    out.insert(QStringLiteral("applied"), applied);
+    out.insert(QStringLiteral("failed"), failed);
+    return out;
+}
+
+QJsonValue QtGenericUiAutomationHandler::waitIdle(const QJsonObject &options, QString *error) {
+    QObject *root = rootRequired(error);
+    if (!root) {
+        return {};
+    }
+    return m_settle->wait({root}, UiSettleMonitor::options(options), m_render.get());
+}
+
+QJsonValue QtGenericUiAutomationHandler::setRenderMode(const QJsonObject &options, QString *error) {
+    QObject *root = rootRequired(error);
+    if (!root) {
+        return {};
+    }
+    QString err;
+    const QJsonValue result = renderModeOf(*m_render, {root}, options, &err);
+    if (!err.isEmpty()) {
+        asError(err, error);
+        return {};
+    }
+    return result;
+}
+
+UiActionRegistry *QtGenericUiAutomationHandler::actionRegistry() {
+    return m_actions.get();
 }
 
 QJsonValue QtGenericUiAutomationHandler::readProperty(
@@ -218,6 +503,8 @@ QJsonValue QtGenericUiAutomationHandler::screenshot(const QString &path, QString
     }
     const QFileInfo info(path);
     info.absoluteDir().mkpath(QStringLiteral("."));
+    // 吞吐模式下先补上被推迟的 polish / 重绘
+    m_render->flush();
 
     bool ok = false;
     if (auto *widget = qobject_cast<QWidget *>(root)) {
@@ -243,12 +530,19 @@ QJsonValue QtGenericUiAutomationHandler::screenshot(const QString &path, QString
 }
 
 QJsonValue QtGenericUiAutomationHandler::dumpTree(QString *error) {
+    return dumpTree(QStringList(), error);
+}
+
+QJsonValue QtGenericUiAutomationHandler::dumpTree(const QStringList &fields, QString *error) {
     QObject *root = rootRequired(error);
     if (!root) {
         return {};
     }
-    QJsonArray arr;
     const auto objs = root->findChildren<QObject *>();
+    if (!fields.isEmpty()) {
+        return m_propertyReader->project(objs, fields);
+    }
+    QJsonArray arr;
     for (QObject *obj : objs) {
         QJsonObject line;
         line.insert(QStringLiteral("objectName"), obj->objectName());
@@ -293,29 +587,6 @@ QObject *QtGenericUiAutomationHandler::findTarget(const QJsonObject &target, QSt
         return nullptr;
     };
 
-    const auto findByTextLikeOnce = [&](const QString &value) -> QObject * {
-        QObject *root = m_root;
-        if (!root) {
-            return nullptr;
-        }
-        const auto objs = root->findChildren<QObject *>();
-        for (QObject *obj : objs) {
-            const QVariant text = obj->property("text");
-            if (text.isValid() && text.toString() == value) {
-                return obj;
-            }
-            const QVariant title = obj->property("title");
-            if (title.isValid() && title.toString() == value) {
-                return obj;
-            }
-            const QVariant windowTitle = obj->property("windowTitle");
-            if (windowTitle.isValid() && windowTitle.toString() == value) {
-                return obj;
-            }
-        }
-        return nullptr;
-    };
-
     const QString kind = target.value(QStringLiteral("kind")).toString().trimmed().toLower();
     const QString value = target.value(QStringLiteral("value")).toString().trimmed();
     if (value.isEmpty()) {
@@ -323,6 +594,14 @@ QObject *QtGenericUiAutomationHandler::findTarget(const QJsonObject &target, QSt
         return nullptr;
     }
 
+    if (kind == QStringLiteral("selector")) {
+        QString err;
+        QObject *obj = m_selector->querySelector(root, value, &err, target.value(QStringLiteral("debug")).toBool());
+        if (!obj) {
+            asError(QStringLiteral("target not found by selector %1: %2").arg(value).arg(err), error);
+        }
+        return obj;
+    }
     if (kind == QStringLiteral("objectname")) {
         QObject *obj = findByObjectNameLikeOnce(value);
         if (!obj) {
@@ -339,7 +618,7 @@ QObject *QtGenericUiAutomationHandler::findTarget(const QJsonObject &target, QSt
         return obj;
     }
     if (kind == QStringLiteral("text") || kind == QStringLiteral("title")) {
-        QObject *obj = findByTextLikeOnce(value);
+        QObject *obj = findTextTarget(*m_textIndex, {root}, target, value);
         if (!obj) {
             asError(QStringLiteral("target not found by text/title: %1").arg(value), error);
         }
@@ -436,6 +715,25 @@ bool QtGenericUiAutomationHandler::setTextValue(QObject *obj, const QString &val
     return invokeSetString(obj, "setText", value);
 }
 
+// 常用属性走控件专用的 setter，其余只写声明过的 Q_PROPERTY（不新建动态属性）
+bool QtGenericUiAutomationHandler::writeProperty(QObject *obj, const QString &property, const QVariant &value) const {
+    if (property == QStringLiteral("text")) {
+        return setTextValue(obj, value.toString());
+    }
+    if (property == QStringLiteral("checked")) {
+        return setChecked(obj, value.toBool());
+    }
+    if (property == QStringLiteral("currentText")) {
+        return setCurrentText(obj, value.toString());
+    }
+    if (property == QStringLiteral("currentIndex")) {
+        return setCurrentIndex(obj, value.toInt());
+    }
+    const QMetaObject *mo = obj->metaObject();
+    const int index = mo->indexOfProperty(property.toLatin1().constData());
+    return index >= 0 && mo->property(index).write(obj, value);
+}
+
 QObject *QtGenericUiAutomationHandler::rootRequired(QString *error) const {
     if (m_root) {
         return m_root;
@@ -1,5 +1,12 @@
 #include "UiAutomationProxyServer.h"
+#include "UiActionRegistry.h"
+#include "UiMethodCache.h"
+#include "UiPropertyReader.h"
 #include "UiQMLQuery.h"
+#include "UiRenderThrottle.h"
+#include "UiSettleMonitor.h"
+#include "UiTextIndex.h"
+#include "UiTypeSchema.h"
 
 #include <QQmlApplicationEngine>
 #include <QAbstractItemModel>
@@ -33,118 +40,84 @@ QJsonValue toJson(const QVariant &value) {
     return QJsonValue::fromVariant(value);
 }
 
+QJsonObject describeTarget(QObject *obj) {
+    QJsonObject out;
+    out.insert(QStringLiteral("objectName"), obj->objectName());
+    out.insert(QStringLiteral("className"), QString::fromUtf8(obj->metaObject()->className()));
+    const QVariant text = obj->property("text");
+    if (text.isValid()) {
+        out.insert(QStringLiteral("text"), toJson(text));
+    }
+    const QVariant title = obj->property("title");
+    if (title.isValid()) {
+        out.insert(QStringLiteral("title"), toJson(title));
+    }
+    const QVariant visible = obj->property("visible");
+    if (visible.isValid()) {
+        out.insert(QStringLiteral("visible"), visible.toBool());
+    }
+    return out;
+}
+
 bool invokeNoArgs(QObject *obj, const char *method) {
     if (!obj) {
         return false;
     }
-    return QMetaObject::invokeMethod(obj, method, Qt::DirectConnection);
+    const QMetaMethod m = UiMethodCache::bySignature(obj->metaObject(), QByteArray(method) + "()");
+    return m.isValid() && m.invoke(obj, Qt::DirectConnection);
 }
 
 bool invokeSetBool(QObject *obj, const char *method, bool value) {
     if (!obj) {
         return false;
     }
-    return QMetaObject::invokeMethod(obj, method, Qt::DirectConnection, Q_ARG(bool, value));
+    const QMetaMethod m = UiMethodCache::bySignature(obj->metaObject(), QByteArray(method) + "(bool)");
+    return m.isValid() && m.invoke(obj, Qt::DirectConnection, Q_ARG(bool, value));
 }
 
 bool invokeSetInt(QObject *obj, const char *method, int value) {
     if (!obj) {
         return false;
     }
-    return QMetaObject::invokeMethod(obj, method, Qt::DirectConnection, Q_ARG(int, value));
+    const QMetaMethod m = UiMethodCache::bySignature(obj->metaObject(), QByteArray(method) + "(int)");
+    return m.isValid() && m.invoke(obj, Qt::DirectConnection, Q_ARG(int, value));
 }
 
 bool invokeSetString(QObject *obj, const char *method, const QString &value) {
     if (!obj) {
         return false;
     }
-    return QMetaObject::invokeMethod(obj, method, Qt::DirectConnection, Q_ARG(QString, value));
+    const QMetaMethod m = UiMethodCache::bySignature(obj->metaObject(), QByteArray(method) + "(QString)");
+    return m.isValid() && m.invoke(obj, Qt::DirectConnection, Q_ARG(QString, value));
 }
 
-// Find method by name; prefers 0 args, then 1 arg (QVariant or basic type). Returns invalid if not found.
-QMetaMethod findInvokableMethod(QObject *obj, const QByteArray &methodName) {
-    if (!obj) {
-        return QMetaMethod();
-    }
-    const QMetaObject *mo = obj->metaObject();
-    QMetaMethod candidate;
-    int candidateParamCount = -1;
-
-    for (int i = 0; i < mo->methodCount(); ++i) {
-        QMetaMethod m = mo->method(i);
-        
-        // 修正 1: 必须包含 QMetaMethod::Signal
-        // 在 QML 中，自定义信号（如 cusClicked）在 C++ 侧被识别为 Signal 类型 
-        if (m.methodType() != QMetaMethod::Slot && 
-            m.methodType() != QMetaMethod::Method && 
-            m.methodType() != QMetaMethod::Signal) {
-            continue;
-        }
-
-        if (m.name() != methodName) {
-            continue;
-        }
-
-        const int paramCount = m.parameterCount();
-        
-        // 优先选择无参方法
-        if (paramCount == 0) {
-            return m;
-        }
-
-        // 修正 2: 处理带 1 个参数的情况（对应 QML 中的 cusClicked(mouse: var)） 
-        if (paramCount == 1 && candidateParamCount != 0) {
-            const int typeId = m.parameterType(0);
-            
-            // QML 中的 'var' 类型在 C++ 元对象系统中映射为 QMetaType::QVariant 
-            if (typeId == QMetaType::QVariant || typeId == QMetaType::Bool
-                || typeId == QMetaType::Int || typeId == QMetaType::QString) {
-                
-                if (candidateParamCount < 0 || paramCount < candidateParamCount) {
-                    candidate = m;
-                    candidateParamCount = paramCount;
-                }
-            }
-        }
-    }
-    return candidateParamCount >= 0 ? candidate : QMetaMethod();
-}
-
-// Invoke method by name; determines parameter types and converts args or passes QVariant dummy.
+// Invoke method by name (resolved through UiMethodCache); converts the first arg to the parameter type
+// or passes an invalid QVariant.
 bool invokeWithSignature(QObject *obj, const QByteArray &methodName, const QVariantList &args, QString *error) {
     if (!obj) {
         if (error) *error = QStringLiteral("object is null");
         return false;
     }
-    QMetaMethod method = findInvokableMethod(obj, methodName);
+    const QMetaMethod method = UiMethodCache::byName(obj->metaObject(), methodName);
     if (!method.isValid()) {
         if (error) *error = QStringLiteral("method not found or not invokable: %1").arg(QString::fromUtf8(methodName));
         return false;
     }
-    const int paramCount = method.parameterCount();
-    if (paramCount == 0) {
-        return QMetaObject::invokeMethod(obj, methodName.constData(), Qt::DirectConnection);
+    if (method.parameterCount() == 0) {
+        return method.invoke(obj, Qt::DirectConnection);
     }
-    if (paramCount == 1) {
-        const int typeId = method.parameterType(0);
-        QVariant arg = (args.size() > 0 && args.at(0).isValid()) ? args.at(0) : QVariant();
-        if (typeId == QMetaType::QVariant) {
-            return QMetaObject::invokeMethod(obj, methodName.constData(), Qt::DirectConnection, Q_ARG(QVariant, arg));
-        }
-        if (typeId == QMetaType::Bool) {
-            return QMetaObject::invokeMethod(obj, methodName.constData(), Qt::DirectConnection, Q_ARG(bool, arg.toBool()));
-        }
-        if (typeId == QMetaType::Int) {
-            return QMetaObject::invokeMethod(obj, methodName.constData(), Qt::DirectConnection, Q_ARG(int, arg.toInt()));
-        }
-        if (typeId == QMetaType::QString) {
-            return QMetaObject::invokeMethod(obj, methodName.constData(), Qt::DirectConnection, Q_ARG(QString, arg.toString()));
-        }
-        if (error) *error = QStringLiteral("unsupported parameter type for method: %1").arg(QString::fromUtf8(methodName));
-        return false;
+    const int typeId = method.parameterType(0);
+    const QVariant arg = (args.size() > 0 && args.at(0).isValid()) ? args.at(0) : QVariant();
+    if (typeId == QMetaType::QVariant) {
+        return method.invoke(obj, Qt::DirectConnection, Q_ARG(QVariant, arg));
+    }
+    if (typeId == QMetaType::Bool) {
+        return method.invoke(obj, Qt::DirectConnection, Q_ARG(bool, arg.toBool()));
+    }
+    if (typeId == QMetaType::Int) {
+        return method.invoke(obj, Qt::DirectConnection, Q_ARG(int, arg.toInt()));
     }
-    if (error) *error = QStringLiteral("method has more than one parameter: %1").arg(QString::fromUtf8(methodName));
-    return false;
+    return method.invoke(obj, Qt::DirectConnection, Q_ARG(QString, arg.toString()));
 }
 
 int findModelIndexForText(const QVariant &model, const QString &text) {
@@ -184,7 +157,19 @@ static const int kFindIntervalMs = 100;
 }  // namespace
 
 QtQmlUiAutomationHandler::QtQmlUiAutomationHandler(QQmlApplicationEngine *engine)
-    : m_engine(engine) {}
+    : m_engine(engine), m_selector(std::make_unique<QmlQuerySelector>()),
+      m_textIndex(std::make_unique<UiTextIndex>(
+          QStringList{QStringLiteral("text"), QStringLiteral("title"), QStringLiteral("placeholderText")})),
+      m_propertyReader(std::make_unique<UiPropertyReader>()),
+      m_typeSchema(std::make_unique<UiTypeSchema>()),
+      m_actions(std::make_unique<UiActionRegistry>()),
+      m_settle(std::make_unique<UiSettleMonitor>()),
+      m_render(std::make_unique<UiRenderThrottle>()) {
+    m_selector->setResultCacheCapacity(kSelectorCacheCapacity);
+    registerBuiltinActions();
+}
+
+QtQmlUiAutomationHandler::~QtQmlUiAutomationHandler() = default;
 
 void QtQmlUiAutomationHandler::setEngine(QQmlApplicationEngine *engine) {
     m_engine = engine;
@@ -206,20 +191,217 @@ QJsonValue QtQmlUiAutomationHandler::resolve(const QJsonObject &target, QString
     if (!obj) {
         return {};
     }
-    QJsonObject out;
-    out.insert(QStringLiteral("objectName"), obj->objectName());
-    out.insert(QStringLiteral("className"), QString::fromUtf8(obj->metaObject()->className()));
-    const QVariant text = obj->property("text");
-    if (text.isValid()) {
-        out.insert(QStringLiteral("text"), toJson(text));
+    return describeTarget(obj);
+}
+
+QJsonValue QtQmlUiAutomationHandler::resolve(const QJsonObject &target, const QStringList &fields, QString *error) {
+    if (fields.isEmpty()) {
+        return resolve(target, error);
     }
-    const QVariant title = obj->property("title");
-    if (title.isValid()) {
-        out.insert(QStringLiteral("title"), toJson(title));
+    QObject *obj = findTarget(target, error);
+    if (!obj) {
+        return {};
     }
-    const QVariant visible = obj->property("visible");
-    if (visible.isValid()) {
-        out.insert(QStringLiteral("visible"), visible.toBool());
+    return m_propertyReader->project(obj, fields);
+}
+
+// 无超时的 selector 目标合并为每个根一次 querySelectorMulti 遍历，
+// 已命中或解析失败的选择器不再查后续根；带 timeout 或其他 kind 的目标逐个 findTarget
+QVector<QObject *> QtQmlUiAutomationHandler::findTargets(const QList<QObject *> &roots, const QJsonArray &targets,
+                                                         QVector<QString> *errors) const {
+    QVector<QObject *> found(targets.size(), nullptr);
+    errors->fill(QString(), targets.size());
+    QStringList selectors;
+    QVector<int> selectorSlots;
+    bool debug = false;
+    for (int i = 0; i < targets.size(); ++i) {
+        const QJsonObject target = targets.at(i).toObject();
+        const QString kind = target.value(QStringLiteral("kind")).toString().trimmed().toLower();
+        const QString value = target.value(QStringLiteral("value")).toString().trimmed();
+        const int timeout = target.value(QStringLiteral("timeout")).toInt(0);
+        if (kind == QStringLiteral("selector") && !value.isEmpty() && timeout <= 0) {
+            selectors.append(value);
+            selectorSlots.append(i);
+            debug = debug || target.value(QStringLiteral("debug")).toBool();
+            continue;
+        }
+        found[i] = findTarget(target, &(*errors)[i]);
+    }
+
+    QVector<QObject *> hits(selectors.size(), nullptr);
+    QVector<QString> selectorErrors(selectors.size());
+    QVector<int> pending;
+    for (int j = 0; j < selectors.size(); ++j) {
+        pending.append(j);
+    }
+    for (QObject *root : roots) {
+        if (pending.isEmpty()) {
+            break;
+        }
+        QStringList batch;
+        for (int j : pending) {
+            batch.append(selectors.at(j));
+        }
+        QStringList batchErrors;
+        const auto results = m_selector->querySelectorMulti(root, batch, &batchErrors, true, debug);
+        QVector<int> unresolved;
+        for (int k = 0; k < pending.size(); ++k) {
+            const int j = pending.at(k);
+            if (!results.at(k).isEmpty()) {
+                hits[j] = results.at(k).first();
+            } else if (!batchErrors.at(k).isEmpty()) {
+                selectorErrors[j] = batchErrors.at(k);
+            } else {
+                unresolved.append(j);
+            }
+        }
+        pending = unresolved;
+    }
+    for (int j = 0; j < selectors.size(); ++j) {
+        found[selectorSlots.at(j)] = hits.at(j);
+        if (!hits.at(j)) {
+            (*errors)[selectorSlots.at(j)] =
+                QStringLiteral("target not found by selector %1: %2").arg(selectors.at(j)).arg(selectorErrors.at(j));
+        }
+    }
+    return found;
+}
+
+QJsonValue QtQmlUiAutomationHandler::resolveMany(const QJsonArray &targets, QString *error) {
+    const QList<QObject *> roots = m_engine ? m_engine->rootObjects() : QList<QObject *>();
+    if (roots.isEmpty()) {
+        setError(QStringLiteral("root object is not configured (engine is null or has no root objects)"), error);
+        return {};
+    }
+
+    QVector<QString> errors;
+    const QVector<QObject *> found = findTargets(roots, targets, &errors);
+    QJsonArray out;
+    for (int i = 0; i < found.size(); ++i) {
+        out.append(found.at(i) ? resolveManyEntry(describeTarget(found.at(i)), QString())
+                               : resolveManyEntry(QJsonValue(), errors.at(i)));
+    }
+    return out;
+}
+
+// selector 目标取全部根下的全部命中（按根顺序拼接）
+QJsonValue QtQmlUiAutomationHandler::readProperties(const QJsonArray &targets, const QJsonObject &selector,
+                                                    const QStringList &properties, QString *error) {
+    const QList<QObject *> roots = m_engine ? m_engine->rootObjects() : QList<QObject *>();
+    if (roots.isEmpty()) {
+        setError(QStringLiteral("root object is not configured (engine is null or has no root objects)"), error);
+        return {};
+    }
+
+    QVector<QObject *> objects;
+    QVector<QString> errors;
+    if (!selector.isEmpty()) {
+        const QString kind = selector.value(QStringLiteral("kind")).toString().trimmed().toLower();
+        if (kind != QStringLiteral("selector")) {
+            setError(QStringLiteral("read_properties target must be a selector"), error);
+            return {};
+        }
+        const QString value = selector.value(QStringLiteral("value")).toString().trimmed();
+        const bool debug = selector.value(QStringLiteral("debug")).toBool();
+        for (QObject *root : roots) {
+            QString err;
+            const auto objs = m_selector->querySelectorAll(root, value, SelectorRange(), &err, debug);
+            if (!err.isEmpty()) {
+                setError(err, error);
+                return {};
+            }
+            for (QObject *obj : objs) {
+                objects.append(obj);
+            }
+        }
+    } else {
+        objects = findTargets(roots, targets, &errors);
+    }
+    return propertyTable(*m_propertyReader, objects, errors, properties);
+}
+
+QJsonValue QtQmlUiAutomationHandler::selectorCacheStats(QString *error) {
+    Q_UNUSED(error)
+    return selectorCacheStatsJson(*m_selector);
+}
+
+std::shared_ptr<const UiSceneSnapshot> QtQmlUiAutomationHandler::captureSnapshot(const QSet<QString> &properties, QString *error) {
+    auto snapshot = m_selector->snapshot(searchRoots(), properties);
+    if (!snapshot) {
+        setError(QStringLiteral("root object is not configured (engine is null or has no root objects)"), error);
+    }
+    return snapshot;
+}
+
+QJsonValue QtQmlUiAutomationHandler::describeType(const QJsonObject &target, const QString &className, QString *error) {
+    QObject *obj = nullptr;
+    if (!target.isEmpty()) {
+        obj = findTarget(target, error);
+        if (!obj) {
+            return {};
+        }
+    }
+    return describeTypeOf(*m_typeSchema, obj, className, searchRoots(), error);
+}
+
+QList<QObject *> QtQmlUiAutomationHandler::searchRoots() const {
+    return m_engine ? m_engine->rootObjects() : QList<QObject *>();
+}
+
+QStringList QtQmlUiAutomationHandler::textProperties() const {
+    return m_textIndex->properties();
+}
+
+// 多个根对象视为按顺序拼接的一棵树：offset 跨根消耗，
+// 每个根只收集到 "剩余 offset + 剩余 limit" 个命中即停止
+QJsonValue QtQmlUiAutomationHandler::queryAll(const QJsonObject &target, int offset, int limit, bool countOnly, QString *error) {
+    const QList<QObject *> roots = m_engine ? m_engine->rootObjects() : QList<QObject *>();
+    if (roots.isEmpty()) {
+        setError(QStringLiteral("root object is not configured (engine is null or has no root objects)"), error);
+        return {};
+    }
+    const QString kind = target.value(QStringLiteral("kind")).toString().trimmed().toLower();
+    const QString value = target.value(QStringLiteral("value")).toString().trimmed();
+    const bool debug = target.value(QStringLiteral("debug")).toBool();
+    if (kind != QStringLiteral("selector")) {
+        setError(QStringLiteral("query_all requires a selector target"), error);
+        return {};
+    }
+
+    int skip = qMax(0, offset);
+    int taken = 0;
+    QJsonArray items;
+    for (QObject *root : roots) {
+        SelectorRange window;
+        window.limit = limit > 0 ? skip + limit - taken : 0;
+        QString err;
+        int hits = 0;
+        QList<QObject *> objs;
+        if (countOnly) {
+            hits = m_selector->countSelectorAll(root, value, window, &err);
+        } else {
+            objs = m_selector->querySelectorAll(root, value, window, &err, debug);
+            hits = objs.size();
+        }
+        if (!err.isEmpty()) {
+            setError(err, error);
+            return {};
+        }
+        const int dropped = qMin(skip, hits);
+        skip -= dropped;
+        taken += hits - dropped;
+        for (int i = dropped; i < objs.size(); ++i) {
+            items.append(describeTarget(objs.at(i)));
+        }
+        if (limit > 0 && taken >= limit) {
+            break;
+        }
+    }
+
+    QJsonObject out;
+    out.insert(QStringLiteral("count"), taken);
+    if (!countOnly) {
+        out.insert(QStringLiteral("items"), items);
     }
     return out;
 }
@@ -234,9 +416,13 @@ QJsonValue QtQmlUiAutomationHandler::executeAction(
         return {};
     }
 
-    const QString op = action.trimmed().toLower();
+    const UiActionRegistry::Action *entry = m_actions->find(action);
+    if (!entry) {
+        setError(QStringLiteral("unsupported action: %1").arg(action), error);
+        return {};
+    }
     QObject *obj = nullptr;
-    if (op == QStringLiteral("close_page") && target.isEmpty()) {
+    if ((entry->flags & UiActionRegistry::RootIfNoTarget) && target.isEmpty()) {
         obj = root;
     } else {
         obj = findTarget(target, error);
@@ -245,7 +431,22 @@ QJsonValue QtQmlUiAutomationHandler::executeAction(
         }
     }
 
-    if (op == QStringLiteral("click")) {
+    QString err;
+    const QJsonValue result = entry->handler(obj, value, &err);
+    if (!err.isEmpty()) {
+        setError(err, error);
+        return {};
+    }
+    if (!(entry->flags & UiActionRegistry::NoSettle)) {
+        QCoreApplication::processEvents();
+    }
+    return result;
+}
+
+// 内置动作；失败信息与原分支链一致
+void QtQmlUiAutomationHandler::registerBuiltinActions() {
+    UiActionRegistry &actions = *m_actions;
+    actions.add(QStringLiteral("click"), [this](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         QString methodName;
         QVariantList args;
         if (!value.isUndefined() && !value.isNull()) {
@@ -265,85 +466,159 @@ QJsonValue QtQmlUiAutomationHandler::executeAction(
         QString err;
         if (!clickObject(obj, methodName, &err, args)) {
             setError(QStringLiteral("click not supported by target: %1").arg(err), error);
-            return {};
         }
-    } else if (op == QStringLiteral("input")) {
+        return {};
+    });
+    actions.add(QStringLiteral("input"), [this](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         if (!setPropertyValue(obj, QStringLiteral("text"), value.toString())) {
             setError(QStringLiteral("input requires a text-capable target"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("upload")) {
+        return {};
+    });
+    actions.add(QStringLiteral("upload"), [this](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         const QString abs = QFileInfo(value.toString()).absoluteFilePath();
         if (!setPropertyValue(obj, QStringLiteral("text"), abs)) {
             setError(QStringLiteral("upload requires a text-capable target"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("select")) {
+        return {};
+    });
+    actions.add(QStringLiteral("select"), [this](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         if (!setPropertyValue(obj, QStringLiteral("currentText"), value.toString())) {
             setError(QStringLiteral("select requires currentText/currentIndex support"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("switch_page")) {
+        return {};
+    });
+    actions.add(QStringLiteral("switch_page"), [this](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         if (value.isDouble()) {
             if (!setPropertyValue(obj, QStringLiteral("currentIndex"), value.toInt())) {
                 setError(QStringLiteral("switch_page(index) not supported"), error);
-                return {};
             }
-        } else {
-            bool asInt = false;
-            const QString raw = value.toString();
-            const int idx = raw.toInt(&asInt);
-            if (asInt) {
-                if (!setPropertyValue(obj, QStringLiteral("currentIndex"), idx)) {
-                    setError(QStringLiteral("switch_page(index) not supported"), error);
-                    return {};
-                }
-            } else if (!setPropertyValue(obj, QStringLiteral("currentText"), raw)) {
-                setError(QStringLiteral("switch_page(text) not supported"), error);
-                return {};
+            return {};
+        }
+        bool asInt = false;
+        const QString raw = value.toString();
+        const int idx = raw.toInt(&asInt);
+        if (asInt) {
+            if (!setPropertyValue(obj, QStringLiteral("currentIndex"), idx)) {
+                setError(QStringLiteral("switch_page(index) not supported"), error);
             }
+        } else if (!setPropertyValue(obj, QStringLiteral("currentText"), raw)) {
+            setError(QStringLiteral("switch_page(text) not supported"), error);
         }
-    } else if (op == QStringLiteral("slide")) {
+        return {};
+    });
+    actions.add(QStringLiteral("slide"), [](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         if (!obj->setProperty("value", value.toVariant()) &&
             !invokeSetInt(obj, "setValue", value.toInt())) {
             setError(QStringLiteral("slide requires value support"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("toggle")) {
+        return {};
+    });
+    actions.add(QStringLiteral("toggle"), [this](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         if (value.isBool()) {
             if (!setPropertyValue(obj, QStringLiteral("checked"), value.toBool())) {
                 setError(QStringLiteral("toggle(bool) not supported"), error);
-                return {};
             }
         } else if (!clickObject(obj)) {
             setError(QStringLiteral("toggle requires click or checked support"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("single_select")) {
+        return {};
+    });
+    actions.add(QStringLiteral("single_select"), [this](QObject *obj, const QJsonValue &, QString *error) -> QJsonValue {
         if (!setPropertyValue(obj, QStringLiteral("checked"), true) && !clickObject(obj)) {
             setError(QStringLiteral("single_select not supported"), error);
-            return {};
         }
-    } else if (op == QStringLiteral("close_page")) {
+        return {};
+    });
+    actions.add(QStringLiteral("close_page"), [this](QObject *obj, const QJsonValue &, QString *error) -> QJsonValue {
         if (!closeObject(obj)) {
             setError(QStringLiteral("close_page not supported"), error);
-            return {};
         }
-    } else if ( op == QStringLiteral("set")) {
+        return {};
+    }, UiActionRegistry::RootIfNoTarget);
+    actions.add(QStringLiteral("set"), [this](QObject *obj, const QJsonValue &value, QString *error) -> QJsonValue {
         const QJsonObject vo = value.toObject();
         const QString key = vo.value(QStringLiteral("property")).toString();
         const QVariant val = vo.value(QStringLiteral("value")).toVariant();
         if (!setPropertyValue(obj, key, val)) {
             setError(QStringLiteral("set requires a property support"), error);
-            return {};
         }
-    } else {
-        setError(QStringLiteral("unsupported action: %1").arg(action), error);
         return {};
+    });
+}
+
+QJsonValue QtQmlUiAutomationHandler::apply(const QJsonArray &updates, QString *error) {
+    const QList<QObject *> roots = m_engine ? m_engine->rootObjects() : QList<QObject *>();
+    if (roots.isEmpty()) {
+        setError(QStringLiteral("root object is not configured (engine is null or has no root objects)"), error);
+        return {};
+    }
+
+    QJsonArray targets;
+    for (const QJsonValue &update : updates) {
+        targets.append(update.toObject().value(QStringLiteral("target")));
     }
+    QVector<QString> errors;
+    const QVector<QObject *> found = findTargets(roots, targets, &errors);
 
+    const auto write = [this](QObject *obj, const QString &property, const QVariant &value) {
+        return setPropertyValue(obj, property, value);
+    };
+    int applied = 0;
+    QJsonArray failed;
+    for (int i = 0; i < updates.size(); ++i) {
+        QString err = errors.at(i);
+        if (found.at(i)) {
+            applyOne(*m_actions, found.at(i), updates.at(i).toObject(), write, &err);
+        } else if (err.isEmpty()) {
+            err = QStringLiteral("target not found");
+        }
+        if (err.isEmpty()) {
+            ++applied;
+            continue;
+        }
+        QJsonObject failure;
+        failure.insert(QStringLiteral("index"), i);
+        failure.insert(QStringLiteral("error"), err);
+        failed.append(failure);
+    }
+
+    // 所有更新写完之后只处理一次事件：期间投递的 LayoutRequest / UpdateRequest /
+    // polish 已合并，布局与渲染只跑一轮
     QCoreApplication::processEvents();
-    return {};
+
+    QJsonObject out;
+    out.insert(QStringLiteral("applied"), applied);
+    out.insert(QStringLiteral("failed"), failed);
+    return out;
+}
+
+QJsonValue QtQmlUiAutomationHandler::waitIdle(const QJsonObject &options, QString *error) {
+    const QList<QObject *> roots = m_engine ? m_engine->rootObjects() : QList<QObject *>();
+    if (roots.isEmpty()) {
+        setError(QStringLiteral("root object is not configured (engine is null or has no root objects)"), error);
+        return {};
+    }
+    return m_settle->wait(roots, UiSettleMonitor::options(options), m_render.get());
+}
+
+QJsonValue QtQmlUiAutomationHandler::setRenderMode(const QJsonObject &options, QString *error) {
+    const QList<QObject *> roots = m_engine ? m_engine->rootObjects() : QList<QObject *>();
+    if (roots.isEmpty()) {
+        setError(QStringLiteral("root object is not configured (engine is null or has no root objects)"), error);
+        return {};
+    }
+    QString err;
+    const QJsonValue result = renderModeOf(*m_render, roots, options, &err);
+    if (!err.isEmpty()) {
+        setError(err, error);
+        return {};
+    }
+    return result;
+}
+
+UiActionRegistry *QtQmlUiAutomationHandler::actionRegistry() {
+    return m_actions.get();
 }
 
 QJsonValue QtQmlUiAutomationHandler::readProperty(
@@ -369,6 +644,8 @@ QJsonValue QtQmlUiAutomationHandler::screenshot(const QString &path, QString *er
     }
     const QFileInfo info(path);
     info.absoluteDir().mkpath(QStringLiteral("."));
+    // 吞吐模式下先补上被推迟的 polish / 重绘
+    m_render->flush();
 
     bool ok = false;
     if (auto *window = qobject_cast<QQuickWindow *>(root)) {
@@ -393,12 +670,19 @@ QJsonValue QtQmlUiAutomationHandler::screenshot(const QString &path, QString *er
 }
 
 QJsonValue QtQmlUiAutomationHandler::dumpTree(QString *error) {
+    return dumpTree(QStringList(), error);
+}
+
+QJsonValue QtQmlUiAutomationHandler::dumpTree(const QStringList &fields, QString *error) {
     QObject *root = rootRequired(error);
     if (!root) {
         return {};
     }
-    QJsonArray arr;
     const auto objs = root->findChildren<QObject *>();
+    if (!fields.isEmpty()) {
+        return m_propertyReader->project(objs, fields);
+    }
+    QJsonArray arr;
     for (QObject *obj : objs) {
         QJsonObject line;
         line.insert(QStringLiteral("objectName"), obj->objectName());
@@ -468,8 +752,7 @@ QObject *QtQmlUiAutomationHandler::findTargetOnce(const QJsonObject &target, QSt
     if (kind == QStringLiteral("selector")) {
         QString err;
         for (QObject *root : roots) {
-            QmlQuerySelector selector;
-            QObject *obj = selector.querySelector(root, value, &err, debug);
+            QObject *obj = m_selector->querySelector(root, value, &err, debug);
             if (obj) {
                 if (error) {
                     error->clear();
@@ -503,35 +786,6 @@ QObject *QtQmlUiAutomationHandler::findTargetOnce(const QJsonObject &target, QSt
         return nullptr;
     };
 
-    const auto findByTextLikeOnce = [&](const QString &value) -> QObject * {
-        for (QObject *root : roots) {
-            if (!root) {
-                continue;
-            }
-            const auto objs = root->findChildren<QObject *>();
-            for (QObject *obj : objs) {
-                const QVariant text = obj->property("text");
-                if (text.isValid() && text.toString() == value) {
-                    return obj;
-                }
-                const QVariant title = obj->property("title");
-                if (title.isValid() && title.toString() == value) {
-                    return obj;
-                }
-                const QVariant placeholder = obj->property("placeholderText");
-                if (placeholder.isValid() && placeholder.toString() == value) {
-                    return obj;
-                }
-            }
-            if (root->property("text").toString() == value
-                || root->property("title").toString() == value
-                || root->property("placeholderText").toString() == value) {
-                return root;
-            }
-        }
-        return nullptr;
-    };
-
     if (kind == QStringLiteral("objectname")) {
         QObject *obj = findByObjectNameLikeOnce(value);
         if (!obj) {
@@ -552,7 +806,7 @@ QObject *QtQmlUiAutomationHandler::findTargetOnce(const QJsonObject &target, QSt
         return obj;
     }
     if (kind == QStringLiteral("text") || kind == QStringLiteral("title")) {
-        QObject *obj = findByTextLikeOnce(value);
+        QObject *obj = findTextTarget(*m_textIndex, roots, target, value);
         if (!obj) {
             setError(QStringLiteral("target not found by text/title: %1").arg(value), error);
         } else if (error) {
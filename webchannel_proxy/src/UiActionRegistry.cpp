@@ -0,0 +1,20 @@
+/**
+ * UiActionRegistry.cpp  —  Qt 5.15.x
+ *
+ * execute_action 的动作表：规范化 id → 处理函数。
+ */
+
+#include "UiActionRegistry.h"
+
+void UiActionRegistry::add(const QString &id, Handler handler, Flags flags) {
+    m_actions.insert(normalize(id), Action{std::move(handler), flags});
+}
+
+bool UiActionRegistry::remove(const QString &id) {
+    return m_actions.remove(normalize(id)) > 0;
+}
+
+const UiActionRegistry::Action *UiActionRegistry::find(const QString &id) const {
+    const auto it = m_actions.constFind(normalize(id));
+    return it == m_actions.constEnd() ? nullptr : &it.value();
+}
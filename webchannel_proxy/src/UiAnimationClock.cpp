@@ -0,0 +1,118 @@
+/**
+ * UiAnimationClock.cpp  —  Qt 5.15.x
+ *
+ * 自定义动画驱动：调速 / 手动步进。
+ * animation_clock / step_animations 调用使用。
+ */
+
+#include "UiAnimationClock.h"
+
+#include <QCoreApplication>
+#include <QTimerEvent>
+
+#include <private/qabstractanimation_p.h>
+
+#include <algorithm>
+
+UiAnimationClock::UiAnimationClock(QObject* parent)
+    : QAnimationDriver(parent)
+{
+    real_.start();
+    install();
+}
+
+UiAnimationClock::~UiAnimationClock()
+{
+    timer_.stop();
+    if (isInstalled()) uninstall();
+}
+
+void UiAnimationClock::rebase()
+{
+    base_ = elapsed();
+    realMark_ = real_.elapsed();
+}
+
+void UiAnimationClock::setSpeed(qreal speed)
+{
+    rebase();
+    speed_ = std::max<qreal>(0.0, speed);
+}
+
+void UiAnimationClock::setManual(bool manual)
+{
+    if (manual == manual_) return;
+    rebase();
+    manual_ = manual;
+    updateTimer();
+}
+
+qint64 UiAnimationClock::elapsed() const
+{
+    if (manual_) return base_;
+    return base_ + static_cast<qint64>((real_.elapsed() - realMark_) * speed_);
+}
+
+void UiAnimationClock::step(int ms, int frameMs)
+{
+    frameMs = std::max(1, frameMs);
+    for (int remaining = std::max(0, ms); remaining > 0;) {
+        const int delta = std::min(frameMs, remaining);
+        remaining -= delta;
+        base_ += delta;
+        advance();
+        QCoreApplication::processEvents();
+    }
+}
+
+// QUnifiedTimer 按 "驱动启动时刻 + elapsed()" 计时，启动时从零开始
+void UiAnimationClock::start()
+{
+    base_ = 0;
+    realMark_ = real_.elapsed();
+    QAnimationDriver::start();
+    updateTimer();
+}
+
+void UiAnimationClock::stop()
+{
+    QAnimationDriver::stop();
+    updateTimer();
+}
+
+void UiAnimationClock::updateTimer()
+{
+    if (isRunning() && !manual_) {
+        if (!timer_.isActive()) timer_.start(kFrameMs, Qt::PreciseTimer, this);
+    } else {
+        timer_.stop();
+    }
+}
+
+void UiAnimationClock::timerEvent(QTimerEvent* event)
+{
+    if (event->timerId() != timer_.timerId()) {
+        QAnimationDriver::timerEvent(event);
+        return;
+    }
+    advance();
+}
+
+QJsonObject UiAnimationClock::state() const
+{
+    QJsonObject out;
+    out.insert(QStringLiteral("speed"), speed_);
+    out.insert(QStringLiteral("manual"), manual_);
+    out.insert(QStringLiteral("elapsedMs"), static_cast<double>(elapsed()));
+    return out;
+}
+
+void UiAnimationClock::setTimerSpeed(qreal speed)
+{
+    QUnifiedTimer::instance()->setSpeedModifier(std::max<qreal>(0.0, speed));
+}
+
+qreal UiAnimationClock::timerSpeed()
+{
+    return QUnifiedTimer::instance()->speedModifier();
+}
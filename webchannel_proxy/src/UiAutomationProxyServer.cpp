@@ -1,13 +1,25 @@
 #include "UiAutomationProxyServer.h"
+#include "UiActionRegistry.h"
+#include "UiAnimationClock.h"
+#include "UiLiveQuery.h"
+#include "UiPropertyReader.h"
+#include "UiRenderThrottle.h"
+#include "UiSceneSnapshot.h"
+#include "UiTextIndex.h"
+#include "UiTypeSchema.h"
 
 #include <QQmlApplicationEngine>
+#include <QFutureWatcher>
 #include <QHostAddress>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QPointer>
+#include <QThreadPool>
 #include <QWebChannel>
 #include <QWebChannelAbstractTransport>
 #include <QWebSocket>
 #include <QWebSocketServer>
+#include <QtConcurrent/QtConcurrentRun>
 
 class UiAutomationProxyServer::SocketTransport : public QWebChannelAbstractTransport {
     Q_OBJECT
@@ -31,8 +43,230 @@ private:
     QPointer<QWebSocket> m_socket;
 };
 
+namespace {
+QJsonObject keepFields(const QJsonObject &in, const QStringList &fields) {
+    QJsonObject out;
+    for (const QString &field : fields) {
+        const auto it = in.constFind(field);
+        if (it != in.constEnd()) {
+            out.insert(field, it.value());
+        }
+    }
+    return out;
+}
+
+QStringList toStringList(const QJsonValue &value) {
+    QStringList out;
+    for (const QJsonValue &item : value.toArray()) {
+        out.append(item.toString());
+    }
+    return out;
+}
+}  // namespace
+
+QJsonValue UiAutomationHandler::resolve(const QJsonObject &target, const QStringList &fields, QString *error) {
+    const QJsonValue result = resolve(target, error);
+    if (fields.isEmpty() || !result.isObject()) {
+        return result;
+    }
+    return keepFields(result.toObject(), fields);
+}
+
+QJsonValue UiAutomationHandler::dumpTree(const QStringList &fields, QString *error) {
+    const QJsonValue result = dumpTree(error);
+    if (fields.isEmpty() || !result.isArray()) {
+        return result;
+    }
+    QJsonArray out;
+    for (const QJsonValue &line : result.toArray()) {
+        out.append(line.isObject() ? QJsonValue(keepFields(line.toObject(), fields)) : line);
+    }
+    return out;
+}
+
+QJsonValue UiAutomationHandler::resolveMany(const QJsonArray &targets, QString *error) {
+    Q_UNUSED(error)
+    QJsonArray out;
+    for (const QJsonValue &target : targets) {
+        QString itemError;
+        const QJsonValue result = resolve(target.toObject(), &itemError);
+        out.append(resolveManyEntry(result, itemError));
+    }
+    return out;
+}
+
+QJsonValue UiAutomationHandler::queryAll(const QJsonObject &target, int offset, int limit, bool countOnly, QString *error) {
+    Q_UNUSED(target)
+    Q_UNUSED(offset)
+    Q_UNUSED(limit)
+    Q_UNUSED(countOnly)
+    if (error) {
+        *error = QStringLiteral("query_all is not supported by this handler");
+    }
+    return {};
+}
+
+QJsonValue UiAutomationHandler::readProperties(const QJsonArray &targets, const QJsonObject &selector,
+                                               const QStringList &properties, QString *error) {
+    Q_UNUSED(targets)
+    Q_UNUSED(selector)
+    Q_UNUSED(properties)
+    if (error) {
+        *error = QStringLiteral("read_properties is not supported by this handler");
+    }
+    return {};
+}
+
+QJsonValue UiAutomationHandler::describeType(const QJsonObject &target, const QString &className, QString *error) {
+    Q_UNUSED(target)
+    Q_UNUSED(className)
+    if (error) {
+        *error = QStringLiteral("describe_type is not supported by this handler");
+    }
+    return {};
+}
+
+QJsonValue UiAutomationHandler::apply(const QJsonArray &updates, QString *error) {
+    Q_UNUSED(updates)
+    if (error) {
+        *error = QStringLiteral("apply is not supported by this handler");
+    }
+    return {};
+}
+
+QJsonValue UiAutomationHandler::waitIdle(const QJsonObject &options, QString *error) {
+    Q_UNUSED(options)
+    if (error) {
+        *error = QStringLiteral("wait_idle is not supported by this handler");
+    }
+    return {};
+}
+
+QJsonValue UiAutomationHandler::setRenderMode(const QJsonObject &options, QString *error) {
+    Q_UNUSED(options)
+    if (error) {
+        *error = QStringLiteral("render_mode is not supported by this handler");
+    }
+    return {};
+}
+
+QJsonValue UiAutomationHandler::selectorCacheStats(QString *error) {
+    if (error) {
+        *error = QStringLiteral("selector_cache_stats is not supported by this handler");
+    }
+    return QJsonValue();
+}
+
+std::shared_ptr<const UiSceneSnapshot> UiAutomationHandler::captureSnapshot(const QSet<QString> &properties, QString *error) {
+    Q_UNUSED(properties)
+    if (error) {
+        *error = QStringLiteral("snapshot queries are not supported by this handler");
+    }
+    return {};
+}
+
+QJsonObject UiAutomationHandler::selectorCacheStatsJson(const QmlQuerySelector &selector) {
+    const SelectorCacheStats stats = selector.resultCacheStats();
+    const quint64 lookups = stats.hits + stats.misses;
+    QJsonObject out;
+    out.insert(QStringLiteral("hits"), double(stats.hits));
+    out.insert(QStringLiteral("misses"), double(stats.misses));
+    out.insert(QStringLiteral("bypassed"), double(stats.bypassed));
+    out.insert(QStringLiteral("hitRate"), lookups ? double(stats.hits) / double(lookups) : 0.0);
+    out.insert(QStringLiteral("size"), stats.size);
+    out.insert(QStringLiteral("capacity"), stats.capacity);
+    return out;
+}
+
+QJsonObject UiAutomationHandler::propertyTable(UiPropertyReader &reader, const QVector<QObject *> &objects,
+                                               const QVector<QString> &errors, const QStringList &properties) {
+    QJsonObject out = reader.readTable(objects, properties);
+    QJsonArray failures;
+    for (int i = 0; i < errors.size(); ++i) {
+        if (!objects.at(i)) {
+            QJsonObject entry;
+            entry.insert(QStringLiteral("index"), i);
+            entry.insert(QStringLiteral("error"), errors.at(i));
+            failures.append(entry);
+        }
+    }
+    if (!failures.isEmpty()) {
+        out.insert(QStringLiteral("errors"), failures);
+    }
+    return out;
+}
+
+QJsonValue UiAutomationHandler::describeTypeOf(UiTypeSchema &schema, QObject *obj, const QString &className,
+                                               const QList<QObject *> &roots, QString *error) {
+    const QJsonObject schemaJson = obj ? schema.describe(obj->metaObject()) : schema.describe(className, roots);
+    if (schemaJson.isEmpty()) {
+        if (error) {
+            *error = QStringLiteral("unknown type: %1").arg(className);
+        }
+        return {};
+    }
+    return schemaJson;
+}
+
+void UiAutomationHandler::applyOne(UiActionRegistry &actions, QObject *obj, const QJsonObject &update,
+                                   const std::function<bool(QObject *, const QString &, const QVariant &)> &write,
+                                   QString *error) {
+    const QString action = update.value(QStringLiteral("action")).toString();
+    if (!action.isEmpty()) {
+        const UiActionRegistry::Action *entry = actions.find(action);
+        if (!entry) {
+            *error = QStringLiteral("unsupported action: %1").arg(action);
+            return;
+        }
+        entry->handler(obj, update.value(QStringLiteral("value")), error);
+        return;
+    }
+    const QString property = update.value(QStringLiteral("property")).toString().trimmed();
+    if (property.isEmpty()) {
+        *error = QStringLiteral("update requires a property or an action");
+        return;
+    }
+    if (!write(obj, property, update.value(QStringLiteral("value")).toVariant())) {
+        *error = QStringLiteral("property not writable: %1").arg(property);
+    }
+}
+
+QJsonValue UiAutomationHandler::renderModeOf(UiRenderThrottle &throttle, const QList<QObject *> &roots,
+                                             const QJsonObject &options, QString *error) {
+    const QString name = options.value(QStringLiteral("mode")).toString().trimmed().toLower();
+    bool known = false;
+    const UiRenderThrottle::Mode mode = UiRenderThrottle::parseMode(name, &known);
+    if (!known) {
+        *error = QStringLiteral("unknown render mode: %1").arg(name);
+        return {};
+    }
+    throttle.setMode(roots, mode,
+                     options.value(QStringLiteral("intervalMs")).toInt(UiRenderThrottle::kDefaultIntervalMs));
+    return throttle.state();
+}
+
+QObject *UiAutomationHandler::findTextTarget(UiTextIndex &index, const QList<QObject *> &roots, const QJsonObject &target,
+                                             const QString &value) {
+    const bool contains = target.value(QStringLiteral("match")).toString().trimmed().toLower() == QStringLiteral("contains");
+    const Qt::CaseSensitivity cs =
+        target.value(QStringLiteral("caseSensitive")).toBool(true) ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    return index.find(roots, value, contains ? UiTextIndex::Match::Contains : UiTextIndex::Match::Exact, cs);
+}
+
+QJsonObject UiAutomationHandler::resolveManyEntry(const QJsonValue &result, const QString &error) {
+    QJsonObject entry;
+    entry.insert(QStringLiteral("ok"), error.isEmpty());
+    if (error.isEmpty()) {
+        entry.insert(QStringLiteral("result"), result);
+    } else {
+        entry.insert(QStringLiteral("error"), error);
+    }
+    return entry;
+}
+
 UiAutomationBridge::UiAutomationBridge(QObject *parent)
-    : QObject(parent) {}
+    : QObject(parent), m_liveQueries(new UiLiveQueryRegistry(this)) {
+}
 
 void UiAutomationBridge::setHandler(UiAutomationHandler *handler) {
     m_handler = handler;
@@ -42,22 +276,23 @@ UiAutomationHandler *UiAutomationBridge::handler() const {
     return m_handler;
 }
 
-QJsonObject UiAutomationBridge::resolve(const QJsonObject &target) const {
+QJsonObject UiAutomationBridge::resolve(const QJsonObject &target, const QStringList &fields) const {
     if (!m_handler) {
         return fail(QStringLiteral("Handler is not configured"));
     }
     QString error;
-    const auto result = m_handler->resolve(target, &error);
+    const auto result = m_handler->resolve(target, fields, &error);
     return error.isEmpty() ? ok(result) : fail(error);
 }
 
-QJsonObject UiAutomationBridge::executeAction(const QString &action, const QJsonObject &target, const QJsonValue &value) const {
+QJsonObject UiAutomationBridge::executeAction(const QString &action, const QJsonObject &target, const QJsonValue &value,
+                                              const QJsonValue &settle) const {
     if (!m_handler) {
         return fail(QStringLiteral("Handler is not configured"));
     }
     QString error;
     const auto result = m_handler->executeAction(action, target, value, &error);
-    return error.isEmpty() ? ok(result) : fail(error);
+    return error.isEmpty() ? settled(ok(result), settle) : fail(error);
 }
 
 QJsonObject UiAutomationBridge::readProperty(const QJsonObject &target, const QString &propertyName) const {
@@ -69,6 +304,19 @@ QJsonObject UiAutomationBridge::readProperty(const QJsonObject &target, const QS
     return error.isEmpty() ? ok(result) : fail(error);
 }
 
+QJsonObject UiAutomationBridge::readProperties(const QJsonArray &targets, const QJsonObject &target,
+                                               const QStringList &properties) const {
+    if (!m_handler) {
+        return fail(QStringLiteral("Handler is not configured"));
+    }
+    if (properties.isEmpty()) {
+        return fail(QStringLiteral("read_properties requires a non-empty property list"));
+    }
+    QString error;
+    const auto result = m_handler->readProperties(targets, target, properties, &error);
+    return error.isEmpty() ? ok(result) : fail(error);
+}
+
 QJsonObject UiAutomationBridge::screenshot(const QString &path) const {
     if (!m_handler) {
         return fail(QStringLiteral("Handler is not configured"));
@@ -78,15 +326,259 @@ QJsonObject UiAutomationBridge::screenshot(const QString &path) const {
     return error.isEmpty() ? ok(result) : fail(error);
 }
 
-QJsonObject UiAutomationBridge::dumpTree() const {
+QJsonObject UiAutomationBridge::dumpTree(const QStringList &fields) const {
+    if (!m_handler) {
+        return fail(QStringLiteral("Handler is not configured"));
+    }
+    QString error;
+    const auto result = m_handler->dumpTree(fields, &error);
+    return error.isEmpty() ? ok(result) : fail(error);
+}
+
+QJsonObject UiAutomationBridge::resolveMany(const QJsonArray &targets) const {
+    if (!m_handler) {
+        return fail(QStringLiteral("Handler is not configured"));
+    }
+    QString error;
+    const auto result = m_handler->resolveMany(targets, &error);
+    return error.isEmpty() ? ok(result) : fail(error);
+}
+
+QJsonObject UiAutomationBridge::queryAll(const QJsonObject &target, int offset, int limit, bool countOnly) const {
+    if (!m_handler) {
+        return fail(QStringLiteral("Handler is not configured"));
+    }
+    QString error;
+    const auto result = m_handler->queryAll(target, offset, limit, countOnly, &error);
+    return error.isEmpty() ? ok(result) : fail(error);
+}
+
+QJsonObject UiAutomationBridge::addLiveQuery(const QString &selector) {
+    if (!m_handler) {
+        return fail(QStringLiteral("Handler is not configured"));
+    }
+    QString error;
+    QJsonArray items;
+    const int id = m_liveQueries->add(m_handler->searchRoots(), selector, &items, &error);
+    if (id < 0) {
+        return fail(error.isEmpty() ? QStringLiteral("live query is not supported by this handler") : error);
+    }
+    QJsonObject result;
+    result.insert(QStringLiteral("id"), id);
+    result.insert(QStringLiteral("items"), items);
+    return ok(result);
+}
+
+QJsonObject UiAutomationBridge::removeLiveQuery(int id) {
+    if (!m_liveQueries->remove(id)) {
+        return fail(QStringLiteral("unknown live query: %1").arg(id));
+    }
+    return ok(QJsonValue());
+}
+
+QJsonObject UiAutomationBridge::describeType(const QJsonObject &target, const QString &className) const {
+    if (!m_handler) {
+        return fail(QStringLiteral("Handler is not configured"));
+    }
+    if (target.isEmpty() && className.trimmed().isEmpty()) {
+        return fail(QStringLiteral("describe_type requires a target or a className"));
+    }
+    QString error;
+    const auto result = m_handler->describeType(target, className.trimmed(), &error);
+    return error.isEmpty() ? ok(result) : fail(error);
+}
+
+QJsonObject UiAutomationBridge::apply(const QJsonArray &updates, const QJsonValue &settle) const {
+    if (!m_handler) {
+        return fail(QStringLiteral("Handler is not configured"));
+    }
+    QString error;
+    const auto result = m_handler->apply(updates, &error);
+    return error.isEmpty() ? settled(ok(result), settle) : fail(error);
+}
+
+QJsonObject UiAutomationBridge::setRenderMode(const QJsonObject &options) const {
+    if (!m_handler) {
+        return fail(QStringLiteral("Handler is not configured"));
+    }
+    QString error;
+    const auto result = m_handler->setRenderMode(options, &error);
+    return error.isEmpty() ? ok(result) : fail(error);
+}
+
+QJsonObject UiAutomationBridge::waitIdle(const QJsonObject &options) const {
+    if (!m_handler) {
+        return fail(QStringLiteral("Handler is not configured"));
+    }
+    QString error;
+    const auto result = m_handler->waitIdle(options, &error);
+    return error.isEmpty() ? ok(result) : fail(error);
+}
+
+// settle 模式：动作本身已成功，等待失败（处理器不支持）也只记在 settle 字段里
+QJsonObject UiAutomationBridge::settled(QJsonObject reply, const QJsonValue &settle) const {
+    if (!settle.isObject() && !settle.toBool(false)) {
+        return reply;
+    }
+    QString error;
+    const auto result = m_handler->waitIdle(settle.toObject(), &error);
+    reply.insert(QStringLiteral("settle"), error.isEmpty() ? ok(result) : fail(error));
+    return reply;
+}
+
+QJsonObject UiAutomationBridge::selectorCacheStats() const {
     if (!m_handler) {
         return fail(QStringLiteral("Handler is not configured"));
     }
     QString error;
-    const auto result = m_handler->dumpTree(&error);
+    const QJsonValue result = m_handler->selectorCacheStats(&error);
     return error.isEmpty() ? ok(result) : fail(error);
 }
 
+QFuture<QJsonObject> UiAutomationBridge::queryAllSnapshot(const QJsonObject &target, int offset, int limit, bool countOnly,
+                                                          bool parallel) const {
+    const QString kind = target.value(QStringLiteral("kind")).toString().trimmed().toLower();
+    const QString value = target.value(QStringLiteral("value")).toString().trimmed();
+    const bool textSearch = kind == QStringLiteral("text") || kind == QStringLiteral("title");
+    // 与处理器按 text / title 查找时比较的属性一致
+    const QStringList textProperties = m_handler ? m_handler->textProperties() : QStringList();
+    UiSnapshotQuery::TextMatch textMatch;
+    textMatch.contains = target.value(QStringLiteral("match")).toString().trimmed().toLower() == QStringLiteral("contains");
+    textMatch.cs = target.value(QStringLiteral("caseSensitive")).toBool(true) ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    textMatch.range.offset = offset;
+    textMatch.range.limit = limit;
+    QJsonObject failure;
+    std::shared_ptr<const UiSceneSnapshot> snapshot;
+    if (!m_handler) {
+        failure = fail(QStringLiteral("Handler is not configured"));
+    } else if (kind != QStringLiteral("selector") && !textSearch) {
+        failure = fail(QStringLiteral("query_all requires a selector or text target"));
+    } else if (textSearch && textProperties.isEmpty()) {
+        failure = fail(QStringLiteral("text search is not supported by this handler"));
+    } else {
+        // describeTarget 输出的字段 + 选择器依赖的属性
+        QSet<QString> properties{QStringLiteral("text"), QStringLiteral("title"), QStringLiteral("visible")};
+        QString error;
+        if (textSearch) {
+            for (const QString &name : textProperties) {
+                properties.insert(name);
+            }
+        } else if (!UiSnapshotQuery::requiredProperties(value, &properties, &error)) {
+            failure = fail(error);
+        }
+        if (failure.isEmpty()) {
+            snapshot = m_handler->captureSnapshot(properties, &error);
+            if (!snapshot) {
+                failure = fail(error);
+            }
+        }
+    }
+    if (!snapshot) {
+        return QtConcurrent::run([failure]() { return failure; });
+    }
+
+    return QtConcurrent::run([snapshot, value, textSearch, textProperties, textMatch, offset, limit, countOnly, parallel]() {
+        UiSnapshotQuery query(snapshot);
+        SelectorRange range;
+        range.offset = offset;
+        range.limit = limit;
+        QVector<int> hits;
+        QString error;
+        int count = 0;
+        if (textSearch) {
+            count = query.findText(value, textProperties, countOnly ? nullptr : &hits,
+                                   parallel ? QThreadPool::globalInstance() : nullptr, textMatch);
+        } else if (parallel) {
+            count = query.querySelectorAllParallel(value, range, countOnly ? nullptr : &hits, &error);
+        } else {
+            count = query.querySelectorAll(value, range, countOnly ? nullptr : &hits, &error);
+        }
+        QJsonObject out;
+        out.insert(QStringLiteral("ok"), count >= 0);
+        if (count < 0) {
+            out.insert(QStringLiteral("error"), error);
+            return out;
+        }
+        QJsonObject result;
+        result.insert(QStringLiteral("count"), count);
+        if (!countOnly) {
+            QJsonArray items;
+            for (const int node : hits) {
+                items.append(snapshot->describe(node));
+            }
+            result.insert(QStringLiteral("items"), items);
+        }
+        out.insert(QStringLiteral("result"), result);
+        return out;
+    });
+}
+
+// 动画驱动是进程级的，与处理器无关；在第一次使用时才安装。
+// 线程化 / windows 渲染循环在创建窗口时已装好自己的驱动，QUnifiedTimer
+// 不接受第二个驱动，此时删掉时钟，下次调用重新尝试。
+// 之前经 speedModifier 调过速时，装上后改由时钟承担，避免两处倍率叠加
+bool UiAutomationBridge::ensureAnimationClock(QString *error) {
+    if (m_animationClock) {
+        return true;
+    }
+    auto *clock = new UiAnimationClock(this);
+    if (!clock->isInstalled()) {
+        delete clock;
+        *error = QStringLiteral("manual animation clock could not be installed: another animation driver is active "
+                                "(requires the basic render loop, QSG_RENDER_LOOP=basic)");
+        return false;
+    }
+    clock->setSpeed(UiAnimationClock::timerSpeed());
+    UiAnimationClock::setTimerSpeed(1.0);
+    m_animationClock = clock;
+    return true;
+}
+
+QJsonObject UiAutomationBridge::setAnimationClock(const QJsonObject &options) {
+    const QJsonValue speed = options.value(QStringLiteral("speed"));
+    if (!speed.isUndefined() && (!speed.isDouble() || speed.toDouble() <= 0)) {
+        return fail(QStringLiteral("animation speed must be a positive number"));
+    }
+    const QJsonValue manual = options.value(QStringLiteral("manual"));
+    QString error;
+    if (!ensureAnimationClock(&error)) {
+        // 渲染循环的驱动仍在：只能调速
+        if (manual.toBool(false)) {
+            return fail(error);
+        }
+        if (!speed.isUndefined()) {
+            UiAnimationClock::setTimerSpeed(speed.toDouble());
+        }
+        QJsonObject state;
+        state.insert(QStringLiteral("speed"), UiAnimationClock::timerSpeed());
+        state.insert(QStringLiteral("manual"), false);
+        state.insert(QStringLiteral("driver"), QStringLiteral("speedModifier"));
+        return ok(state);
+    }
+    if (!speed.isUndefined()) {
+        m_animationClock->setSpeed(speed.toDouble());
+    }
+    if (!manual.isUndefined()) {
+        m_animationClock->setManual(manual.toBool());
+    }
+    QJsonObject state = m_animationClock->state();
+    state.insert(QStringLiteral("driver"), QStringLiteral("clock"));
+    return ok(state);
+}
+
+QJsonObject UiAutomationBridge::stepAnimations(int ms, int frameMs) {
+    if (ms < 0) {
+        return fail(QStringLiteral("step_animations requires a non-negative ms"));
+    }
+    QString error;
+    if (!ensureAnimationClock(&error)) {
+        return fail(error);
+    }
+    m_animationClock->setManual(true);
+    m_animationClock->step(ms, frameMs > 0 ? frameMs : UiAnimationClock::kFrameMs);
+    return ok(m_animationClock->state());
+}
+
 QJsonObject UiAutomationBridge::ok(const QJsonValue &result) const {
     QJsonObject out;
     out.insert(QStringLiteral("ok"), true);
@@ -108,6 +600,7 @@ UiAutomationProxyServer::UiAutomationProxyServer(QObject *parent)
       m_bridge(new UiAutomationBridge(this)) {
     m_channel->registerObject(QStringLiteral("qtProxyBridge"), m_bridge);
     connect(m_server, &QWebSocketServer::newConnection, this, &UiAutomationProxyServer::onNewConnection);
+    connect(m_bridge->liveQueries(), &UiLiveQueryRegistry::delta, this, &UiAutomationProxyServer::onLiveQueryDelta);
 }
 
 UiAutomationProxyServer::~UiAutomationProxyServer() {
@@ -133,6 +626,11 @@ UiAutomationBridge *UiAutomationProxyServer::bridge() const {
     return m_bridge;
 }
 
+UiActionRegistry *UiAutomationProxyServer::actionRegistry() const {
+    UiAutomationHandler *handler = m_bridge->handler();
+    return handler ? handler->actionRegistry() : nullptr;
+}
+
 bool UiAutomationProxyServer::start(quint16 port, const QHostAddress &address, const QString &token) {
     m_token = token;
     if (m_server->isListening()) {
@@ -184,6 +682,14 @@ void UiAutomationProxyServer::onNewConnection() {
 }
 
 void UiAutomationProxyServer::onSocketDisconnected(QWebSocket *socket) {
+    for (auto it = m_liveQueryOwners.begin(); it != m_liveQueryOwners.end();) {
+        if (it.value() == socket) {
+            m_bridge->removeLiveQuery(it.key());
+            it = m_liveQueryOwners.erase(it);
+        } else {
+            ++it;
+        }
+    }
     auto *transport = m_transports.take(socket);
     if (transport) {
         m_channel->disconnectFrom(transport);
@@ -224,20 +730,77 @@ void UiAutomationProxyServer::onSocketMessage(QWebSocket *socket, const QString
 
     QJsonObject callResult;
     if (method == QStringLiteral("resolve")) {
-        callResult = m_bridge->resolve(params.value(QStringLiteral("target")).toObject());
+        callResult = m_bridge->resolve(params.value(QStringLiteral("target")).toObject(),
+                                       toStringList(params.value(QStringLiteral("fields"))));
+    } else if (method == QStringLiteral("resolve_many")) {
+        callResult = m_bridge->resolveMany(params.value(QStringLiteral("targets")).toArray());
+    } else if (method == QStringLiteral("query_all")
+               && params.value(QStringLiteral("consistency")).toString() == QStringLiteral("snapshot")) {
+        replyLater(socket, id, m_bridge->queryAllSnapshot(
+            params.value(QStringLiteral("target")).toObject(),
+            params.value(QStringLiteral("offset")).toInt(0),
+            params.value(QStringLiteral("limit")).toInt(0),
+            params.value(QStringLiteral("count_only")).toBool(false),
+            params.value(QStringLiteral("parallel")).toBool(false)));
+        return;
+    } else if (method == QStringLiteral("query_all")) {
+        callResult = m_bridge->queryAll(
+            params.value(QStringLiteral("target")).toObject(),
+            params.value(QStringLiteral("offset")).toInt(0),
+            params.value(QStringLiteral("limit")).toInt(0),
+            params.value(QStringLiteral("count_only")).toBool(false));
+    } else if (method == QStringLiteral("live_query_add")) {
+        callResult = m_bridge->addLiveQuery(params.value(QStringLiteral("selector")).toString());
+        if (callResult.value(QStringLiteral("ok")).toBool(false)) {
+            const int liveId = callResult.value(QStringLiteral("result")).toObject().value(QStringLiteral("id")).toInt();
+            m_liveQueryOwners.insert(liveId, socket);
+        }
+    } else if (method == QStringLiteral("live_query_remove")) {
+        const int liveId = params.value(QStringLiteral("id")).toInt(-1);
+        if (m_liveQueryOwners.value(liveId, nullptr) != socket) {
+            reply(socket, id, QJsonValue(), QStringLiteral("unknown live query: %1").arg(liveId));
+            return;
+        }
+        m_liveQueryOwners.remove(liveId);
+        callResult = m_bridge->removeLiveQuery(liveId);
+    } else if (method == QStringLiteral("selector_cache_stats")) {
+        callResult = m_bridge->selectorCacheStats();
+    } else if (method == QStringLiteral("apply")) {
+        callResult = m_bridge->apply(params.value(QStringLiteral("updates")).toArray(),
+                                     params.value(QStringLiteral("settle")));
+    } else if (method == QStringLiteral("animation_clock")) {
+        callResult = m_bridge->setAnimationClock(params);
+    } else if (method == QStringLiteral("step_animations")) {
+        callResult = m_bridge->stepAnimations(
+            params.value(QStringLiteral("ms")).toInt(0),
+            params.value(QStringLiteral("frameMs")).toInt(0));
+    } else if (method == QStringLiteral("render_mode")) {
+        callResult = m_bridge->setRenderMode(params);
+    } else if (method == QStringLiteral("wait_idle")) {
+        callResult = m_bridge->waitIdle(params);
+    } else if (method == QStringLiteral("describe_type")) {
+        callResult = m_bridge->describeType(
+            params.value(QStringLiteral("target")).toObject(),
+            params.value(QStringLiteral("className")).toString());
     } else if (method == QStringLiteral("execute_action")) {
         callResult = m_bridge->executeAction(
             params.value(QStringLiteral("action")).toString(),
             params.value(QStringLiteral("target")).toObject(),
-            params.value(QStringLiteral("value")));
+            params.value(QStringLiteral("value")),
+            params.value(QStringLiteral("settle")));
     } else if (method == QStringLiteral("read_property")) {
         callResult = m_bridge->readProperty(
             params.value(QStringLiteral("target")).toObject(),
             params.value(QStringLiteral("property")).toString());
+    } else if (method == QStringLiteral("read_properties")) {
+        callResult = m_bridge->readProperties(
+            params.value(QStringLiteral("targets")).toArray(),
+            params.value(QStringLiteral("target")).toObject(),
+            toStringList(params.value(QStringLiteral("properties"))));
     } else if (method == QStringLiteral("screenshot")) {
         callResult = m_bridge->screenshot(params.value(QStringLiteral("path")).toString());
     } else if (method == QStringLiteral("dump_tree")) {
-        callResult = m_bridge->dumpTree();
+        callResult = m_bridge->dumpTree(toStringList(params.value(QStringLiteral("fields"))));
     } else {
         reply(socket, id, QJsonValue(), QStringLiteral("unknown method"));
         return;
@@ -266,4 +829,38 @@ void UiAutomationProxyServer::reply(QWebSocket *socket, int id, const QJsonValue
     socket->sendTextMessage(QString::fromUtf8(QJsonDocument(out).toJson(QJsonDocument::Compact)));
 }
 
+void UiAutomationProxyServer::replyLater(QWebSocket *socket, int id, const QFuture<QJsonObject> &future) {
+    auto *watcher = new QFutureWatcher<QJsonObject>(this);
+    const QPointer<QWebSocket> guard(socket);
+    connect(watcher, &QFutureWatcher<QJsonObject>::finished, this, [this, watcher, guard, id]() {
+        watcher->deleteLater();
+        if (!guard) {
+            return;
+        }
+        const QJsonObject callResult = watcher->result();
+        if (!callResult.value(QStringLiteral("ok")).toBool(false)) {
+            reply(guard.data(), id, QJsonValue(), callResult.value(QStringLiteral("error")).toString());
+            return;
+        }
+        reply(guard.data(), id, callResult.value(QStringLiteral("result")));
+    });
+    watcher->setFuture(future);
+}
+
+// 推送消息不带 id，以 method 区分于请求回复
+void UiAutomationProxyServer::onLiveQueryDelta(int id, const QJsonArray &entered, const QJsonArray &left) {
+    QWebSocket *socket = m_liveQueryOwners.value(id, nullptr);
+    if (!socket) {
+        return;
+    }
+    QJsonObject params;
+    params.insert(QStringLiteral("id"), id);
+    params.insert(QStringLiteral("entered"), entered);
+    params.insert(QStringLiteral("left"), left);
+    QJsonObject out;
+    out.insert(QStringLiteral("method"), QStringLiteral("live_query_delta"));
+    out.insert(QStringLiteral("params"), params);
+    socket->sendTextMessage(QString::fromUtf8(QJsonDocument(out).toJson(QJsonDocument::Compact)));
+}
+
 #include "UiAutomationProxyServer.moc"
@@ -0,0 +1,186 @@
+/**
+ * UiLiveQuery.cpp  —  Qt 5.15.x
+ *
+ * 活动查询：注册时全量查询一次，之后只在变化的 scope 内重新查询，
+ * 与旧命中求差后推送进入 / 离开差量。
+ */
+
+#include "UiLiveQuery.h"
+
+#include <QSet>
+
+UiLiveQueryRegistry::UiLiveQueryRegistry(QObject* parent)
+    : QObject(parent)
+{
+    connect(&watcher_, &UiTreeWatcher::changed, this, &UiLiveQueryRegistry::onTreeChanged);
+}
+
+UiLiveQueryRegistry::~UiLiveQueryRegistry() = default;
+
+int UiLiveQueryRegistry::add(const QList<QObject*>& roots, const QString& selector,
+                             QJsonArray* initial, QString* error)
+{
+    SelectorDependencies deps;
+    if (!selector_.dependencies(selector, &deps, error)) return -1;
+
+    LiveQuery query;
+    query.selector = selector;
+    query.relative = deps.relative;
+    for (QObject* root : roots) {
+        if (root) query.roots.append(root);
+    }
+    if (query.roots.isEmpty()) {
+        if (error) *error = QStringLiteral("live query: no root objects");
+        return -1;
+    }
+
+    // 先挂监听再查询：初始快照之后的变化不会漏掉
+    watcher_.addProperties(deps.properties);
+    for (QObject* root : roots) {
+        if (root) watcher_.watch(root);
+    }
+    for (QObject* root : roots) {
+        if (!root) continue;
+        for (QObject* obj : selector_.querySelectorAll(root, selector)) {
+            if (!query.members.contains(obj)) enter(query, obj, initial);
+        }
+    }
+
+    const int id = nextId_++;
+    queries_.insert(id, query);
+    return id;
+}
+
+bool UiLiveQueryRegistry::remove(int id)
+{
+    return queries_.remove(id) > 0;
+}
+
+QJsonObject UiLiveQueryRegistry::describe(QObject* obj)
+{
+    int ref = refs_.value(obj, 0);
+    if (ref == 0) {
+        ref = nextRef_++;
+        refs_.insert(obj, ref);
+    }
+    QJsonObject out;
+    out.insert(QStringLiteral("ref"), ref);
+    out.insert(QStringLiteral("objectName"), obj->objectName());
+    out.insert(QStringLiteral("className"), QString::fromUtf8(obj->metaObject()->className()));
+    return out;
+}
+
+void UiLiveQueryRegistry::enter(LiveQuery& query, QObject* obj, QJsonArray* entered)
+{
+    const QJsonObject desc = describe(obj);
+    query.members.insert(obj, desc);
+    connect(obj, &QObject::destroyed, this, &UiLiveQueryRegistry::onMemberDestroyed, Qt::UniqueConnection);
+    if (entered) entered->append(desc);
+}
+
+// ────────────────────────────────────────────────────────────────
+//  onTreeChanged — 合并后的变化通知
+//
+//  先算出全部差量再逐个发出：delta 的接收方可能在槽函数里
+//  remove() 查询，不能边遍历 queries_ 边发信号。
+// ────────────────────────────────────────────────────────────────
+void UiLiveQueryRegistry::onTreeChanged(const QList<QObject*>& scopes)
+{
+    struct Pending { int id; QJsonArray entered; QJsonArray left; };
+    QList<Pending> pending;
+    for (auto it = queries_.begin(); it != queries_.end(); ++it) {
+        Pending p{ it.key(), {}, {} };
+        refresh(it.value(), scopes, &p.entered, &p.left);
+        if (!p.entered.isEmpty() || !p.left.isEmpty()) pending.append(p);
+    }
+    for (const Pending& p : pending) emit delta(p.id, p.entered, p.left);
+}
+
+void UiLiveQueryRegistry::onMemberDestroyed(QObject* obj)
+{
+    refs_.remove(obj);
+    QList<QPair<int, QJsonObject>> gone;
+    for (auto it = queries_.begin(); it != queries_.end(); ++it) {
+        const auto m = it.value().members.constFind(obj);
+        if (m == it.value().members.constEnd()) continue;
+        gone.append(qMakePair(it.key(), m.value()));
+        it.value().members.remove(obj);
+    }
+    for (const auto& g : gone) emit delta(g.first, QJsonArray(), QJsonArray{ g.second });
+}
+
+// ────────────────────────────────────────────────────────────────
+//  refresh — 在受影响的 scope 内重新查询
+//
+//  1. 已移出所有注册根的旧命中直接离开（被挂到别处的节点）
+//  2. scope 收敛：不在任何根内的 scope 丢弃，包含根的 scope 收缩为根，
+//     位于原子容器内的 scope 扩大到最外层的原子容器（整根查询不进入其
+//     内部，从内部查询会多出命中），被其他 scope 包含的 scope 去掉；
+//     含 :has 时直接取全部根
+//  3. 每个 scope：新命中 − 旧命中 → 进入；scope 内的旧命中 − 新命中 → 离开
+//
+//  包含关系一律用选择器引擎的树（selector_.isWithin），与查询遍历的
+//  父子关系一致，离开判断与整根查询的结果对得上。
+// ────────────────────────────────────────────────────────────────
+void UiLiveQueryRegistry::refresh(LiveQuery& query, const QList<QObject*>& scopes,
+                                  QJsonArray* entered, QJsonArray* left)
+{
+    QList<QObject*> roots;
+    for (const QPointer<QObject>& root : query.roots) {
+        if (root) roots.append(root.data());
+    }
+    const auto withinRoots = [&](QObject* node) {
+        for (QObject* root : roots) {
+            if (selector_.isWithin(node, root)) return true;
+        }
+        return false;
+    };
+
+    for (auto m = query.members.begin(); m != query.members.end();) {
+        if (!withinRoots(m.key())) {
+            left->append(m.value());
+            m = query.members.erase(m);
+        } else {
+            ++m;
+        }
+    }
+
+    QList<QObject*> targets;
+    if (query.relative) {
+        targets = roots;
+    } else {
+        for (QObject* scope : scopes) {
+            QObject* target = nullptr;
+            for (QObject* root : roots) {
+                if (selector_.isWithin(scope, root)) { target = selector_.requeryScope(root, scope); break; }
+                if (selector_.isWithin(root, scope)) { target = root; break; }
+            }
+            if (target && !targets.contains(target)) targets.append(target);
+        }
+        QList<QObject*> minimal;
+        for (QObject* t : targets) {
+            bool covered = false;
+            for (QObject* other : targets) {
+                if (other != t && selector_.isWithin(t, other)) { covered = true; break; }
+            }
+            if (!covered) minimal.append(t);
+        }
+        targets = minimal;
+    }
+
+    for (QObject* scope : targets) {
+        const QList<QObject*> hits = selector_.querySelectorAll(scope, query.selector);
+        const QSet<QObject*> hitSet(hits.begin(), hits.end());
+        for (auto m = query.members.begin(); m != query.members.end();) {
+            if (!hitSet.contains(m.key()) && selector_.isWithin(m.key(), scope)) {
+                left->append(m.value());
+                m = query.members.erase(m);
+            } else {
+                ++m;
+            }
+        }
+        for (QObject* obj : hits) {
+            if (!query.members.contains(obj)) enter(query, obj, entered);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * UiMethodCache.cpp  —  Qt 5.15.x
+ *
+ * 动作调用的方法解析缓存：(类名, 签名 / 方法名) → 方法下标。
+ */
+
+#include "UiMethodCache.h"
+
+#include <QHash>
+#include <QMetaObject>
+#include <QMetaType>
+#include <QPair>
+
+namespace UiMethodCache {
+namespace {
+
+struct Entry {
+    int        methodCount = -1;
+    int        index = -1;      // -1：不存在
+    QByteArray signature;       // index 处方法的签名，命中时核对
+};
+
+using Key = QPair<QByteArray, QByteArray>;
+
+// 超出后整体清空；正常界面的类型 × 方法名远小于此
+const int kCapacity = 4096;
+
+QHash<Key, Entry>& signatureCache()
+{
+    static QHash<Key, Entry> cache;
+    return cache;
+}
+
+QHash<Key, Entry>& nameCache()
+{
+    static QHash<Key, Entry> cache;
+    return cache;
+}
+
+bool isInvokableKind(const QMetaMethod& m)
+{
+    // QML 中的自定义信号（如 cusClicked）在 C++ 侧是 Signal 类型，同样允许调用
+    return m.methodType() == QMetaMethod::Slot
+        || m.methodType() == QMetaMethod::Method
+        || m.methodType() == QMetaMethod::Signal;
+}
+
+// QML 的 var 参数在元对象系统中为 QMetaType::QVariant
+bool isSupportedParameter(int typeId)
+{
+    return typeId == QMetaType::QVariant || typeId == QMetaType::Bool
+        || typeId == QMetaType::Int || typeId == QMetaType::QString;
+}
+
+int resolveByName(const QMetaObject* mo, const QByteArray& name)
+{
+    int candidate = -1;
+    for (int i = 0; i < mo->methodCount(); ++i) {
+        const QMetaMethod m = mo->method(i);
+        if (!isInvokableKind(m) || m.name() != name) continue;
+        if (m.parameterCount() == 0) return i;
+        if (candidate < 0 && m.parameterCount() == 1 && isSupportedParameter(m.parameterType(0)))
+            candidate = i;
+    }
+    return candidate;
+}
+
+template <typename Resolve>
+QMetaMethod lookup(QHash<Key, Entry>& cache, const QMetaObject* mo, const QByteArray& key, Resolve resolve)
+{
+    if (!mo || key.isEmpty()) return QMetaMethod();
+    const Key cacheKey = qMakePair(QByteArray(mo->className()), key);
+    auto it = cache.find(cacheKey);
+    if (it != cache.end() && it->methodCount == mo->methodCount()
+        && (it->index < 0 || mo->method(it->index).methodSignature() == it->signature)) {
+        return it->index >= 0 ? mo->method(it->index) : QMetaMethod();
+    }
+
+    if (it == cache.end()) {
+        if (cache.size() >= kCapacity) cache.clear();
+        it = cache.insert(cacheKey, Entry());
+    }
+    it->methodCount = mo->methodCount();
+    it->index = resolve();
+    const QMetaMethod method = it->index >= 0 ? mo->method(it->index) : QMetaMethod();
+    it->signature = method.methodSignature();
+    return method;
+}
+
+}  // namespace
+
+QMetaMethod bySignature(const QMetaObject* mo, const QByteArray& signature)
+{
+    return lookup(signatureCache(), mo, signature, [&]() {
+        const int index = mo->indexOfMethod(signature.constData());
+        return index >= 0 ? index : mo->indexOfMethod(QMetaObject::normalizedSignature(signature.constData()));
+    });
+}
+
+QMetaMethod byName(const QMetaObject* mo, const QByteArray& name)
+{
+    return lookup(nameCache(), mo, name, [&]() { return resolveByName(mo, name); });
+}
+
+int size()
+{
+    return signatureCache().size() + nameCache().size();
+}
+
+}  // namespace UiMethodCache
@@ -0,0 +1,122 @@
+/**
+ * UiPropertyReader.cpp  —  Qt 5.15.x
+ *
+ * 批量属性读取：按 QMetaObject 缓存列下标。
+ * read_properties 的紧凑表与 resolve / dump_tree 的字段投影使用。
+ */
+
+#include "UiPropertyReader.h"
+#include "UiSelectorEngine.h"
+
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QMetaObject>
+#include <QMetaProperty>
+#include <QObject>
+
+bool UiPropertyReader::matches(const Layout& entry, const QMetaObject* mo)
+{
+    if (entry.propertyCount != mo->propertyCount()) return false;
+    for (int c = 0; c < entry.indices.size(); ++c) {
+        const int index = entry.indices.at(c);
+        if (index >= 0 && qstrcmp(mo->property(index).name(), entry.names.at(c).constData()) != 0) return false;
+    }
+    return true;
+}
+
+const UiPropertyReader::Layout& UiPropertyReader::layout(LayoutTable& table, const QMetaObject* mo,
+                                                         const QStringList& properties)
+{
+    const char* className = mo->className();
+    const auto it = table.find(QByteArray::fromRawData(className, int(qstrlen(className))));
+    if (it != table.end() && matches(*it, mo)) return *it;
+
+    Layout& entry = it != table.end() ? *it : table[QByteArray(className)];
+    entry.propertyCount = mo->propertyCount();
+    entry.indices.resize(properties.size());
+    entry.names.resize(properties.size());
+    for (int c = 0; c < properties.size(); ++c) {
+        const QString& name = properties.at(c);
+        entry.names[c] = name.toLatin1();
+        entry.indices[c] = name == QLatin1String("className")
+                               ? kClassName
+                               : mo->indexOfProperty(entry.names.at(c).constData());
+    }
+    return entry;
+}
+
+QVariant UiPropertyReader::read(QObject* obj, const QMetaObject* mo, int index, const QString& name)
+{
+    if (index == kClassName) return QString::fromUtf8(mo->className());
+    QVariant v;
+    if (index >= 0) v = mo->property(index).read(obj);
+    if (!v.isValid()) v = SelectorDetail::readProperty(obj, name);
+    return v;
+}
+
+UiPropertyReader::LayoutTable& UiPropertyReader::tableFor(const QStringList& columns)
+{
+    const QString key = columns.join(QLatin1Char(','));
+    if (!layouts_.contains(key) && layouts_.size() >= kMaxColumnSets) layouts_.clear();
+    return layouts_[key];
+}
+
+QJsonObject UiPropertyReader::readTable(const QVector<QObject*>& objects, const QStringList& properties)
+{
+    LayoutTable& table = tableFor(properties);
+
+    QJsonArray rows;
+    for (QObject* obj : objects) {
+        if (!obj) {
+            rows.append(QJsonValue());
+            continue;
+        }
+        const QMetaObject* mo = obj->metaObject();
+        const Layout& cols = layout(table, mo, properties);
+
+        QJsonArray row;
+        for (int c = 0; c < properties.size(); ++c)
+            row.append(QJsonValue::fromVariant(read(obj, mo, cols.indices.at(c), properties.at(c))));
+        rows.append(row);
+    }
+
+    QJsonObject out;
+    out.insert(QStringLiteral("columns"), QJsonArray::fromStringList(properties));
+    out.insert(QStringLiteral("rows"), rows);
+    return out;
+}
+
+QJsonObject UiPropertyReader::projectOne(QObject* obj, LayoutTable& table, const QStringList& fields)
+{
+    QJsonObject out;
+    const QMetaObject* mo = obj->metaObject();
+    const Layout& cols = layout(table, mo, fields);
+    for (int c = 0; c < fields.size(); ++c) {
+        const QVariant v = read(obj, mo, cols.indices.at(c), fields.at(c));
+        if (v.isValid()) out.insert(fields.at(c), QJsonValue::fromVariant(v));
+    }
+    return out;
+}
+
+QJsonObject UiPropertyReader::project(QObject* obj, const QStringList& fields)
+{
+    if (!obj) return {};
+    return projectOne(obj, tableFor(fields), fields);
+}
+
+QJsonArray UiPropertyReader::project(const QList<QObject*>& objects, const QStringList& fields)
+{
+    LayoutTable& table = tableFor(fields);
+    QJsonArray out;
+    for (QObject* obj : objects) {
+        if (obj) out.append(projectOne(obj, table, fields));
+    }
+    return out;
+}
+
+int UiPropertyReader::cachedTypes() const
+{
+    int n = 0;
+    for (const LayoutTable& table : layouts_) n += table.size();
+    return n;
+}
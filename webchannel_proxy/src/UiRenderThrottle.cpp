@@ -0,0 +1,125 @@
+/**
+ * UiRenderThrottle.cpp  —  Qt 5.15.x
+ *
+ * 渲染节流：拦截窗口的 UpdateRequest，挂起或按间隔合并渲染。
+ * render_mode 调用与截图前的 flush 使用。
+ */
+
+#include "UiRenderThrottle.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QWidget>
+#include <QWindow>
+
+#include <QtQuick/QQuickItem>
+
+#include <algorithm>
+
+UiRenderThrottle::UiRenderThrottle(QObject* parent)
+    : QObject(parent)
+{
+    connect(&timer_, &QTimer::timeout, this, &UiRenderThrottle::deliverHeld);
+}
+
+UiRenderThrottle::~UiRenderThrottle()
+{
+    for (QObject* window : qAsConst(windows_)) window->removeEventFilter(this);
+}
+
+UiRenderThrottle::Mode UiRenderThrottle::parseMode(const QString& name, bool* ok)
+{
+    *ok = true;
+    if (name == QLatin1String("normal")) return Mode::Normal;
+    if (name == QLatin1String("throttle")) return Mode::Throttle;
+    if (name == QLatin1String("suspend")) return Mode::Suspend;
+    *ok = false;
+    return Mode::Normal;
+}
+
+QString UiRenderThrottle::modeName(Mode mode)
+{
+    switch (mode) {
+    case Mode::Throttle: return QStringLiteral("throttle");
+    case Mode::Suspend:  return QStringLiteral("suspend");
+    case Mode::Normal:   break;
+    }
+    return QStringLiteral("normal");
+}
+
+void UiRenderThrottle::addWindow(QObject* window)
+{
+    if (!window || windows_.contains(window)) return;
+    windows_.insert(window);
+    window->installEventFilter(this);
+    connect(window, &QObject::destroyed, this, &UiRenderThrottle::onWindowDestroyed);
+}
+
+void UiRenderThrottle::onWindowDestroyed(QObject* window)
+{
+    windows_.remove(window);
+    held_.remove(window);
+}
+
+// 根本身、根下的 QWindow / 顶层 QWidget，以及 QQuickItem 所在的窗口
+void UiRenderThrottle::setMode(const QList<QObject*>& roots, Mode mode, int intervalMs)
+{
+    for (QObject* root : roots) {
+        if (!root) continue;
+        if (auto* item = qobject_cast<QQuickItem*>(root)) addWindow(item->window());
+        if (auto* widget = qobject_cast<QWidget*>(root)) addWindow(widget->window());
+        if (qobject_cast<QWindow*>(root)) addWindow(root);
+        for (QWindow* window : root->findChildren<QWindow*>()) addWindow(window);
+        for (QWidget* widget : root->findChildren<QWidget*>()) {
+            if (widget->isWindow()) addWindow(widget);
+        }
+    }
+
+    mode_ = mode;
+    if (mode_ == Mode::Throttle) {
+        timer_.start(std::max(1, intervalMs));
+    } else {
+        timer_.stop();
+    }
+    if (mode_ == Mode::Normal) deliverHeld();
+}
+
+bool UiRenderThrottle::eventFilter(QObject* watched, QEvent* event)
+{
+    if (event->type() == QEvent::UpdateRequest && mode_ != Mode::Normal && !delivering_) {
+        held_.insert(watched);
+        ++suppressed_;
+        return true;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+// 同步发送，与 QWindow 自身投递 UpdateRequest 的方式一致
+void UiRenderThrottle::deliverHeld()
+{
+    if (held_.isEmpty()) return;
+    const QSet<QObject*> windows = held_;
+    held_.clear();
+    delivering_ = true;
+    for (QObject* window : windows) {
+        QEvent request(QEvent::UpdateRequest);
+        QCoreApplication::sendEvent(window, &request);
+    }
+    delivering_ = false;
+}
+
+void UiRenderThrottle::flush()
+{
+    deliverHeld();
+    QCoreApplication::processEvents();
+}
+
+QJsonObject UiRenderThrottle::state() const
+{
+    QJsonObject out;
+    out.insert(QStringLiteral("mode"), modeName(mode_));
+    out.insert(QStringLiteral("intervalMs"), mode_ == Mode::Throttle ? timer_.interval() : 0);
+    out.insert(QStringLiteral("windows"), windows_.size());
+    out.insert(QStringLiteral("suppressed"), static_cast<double>(suppressed_));
+    return out;
+}
@@ -0,0 +1,456 @@
+/**
+ * UiSceneSnapshot.cpp  —  Qt 5.15.x
+ *
+ * 场景快照：GUI 线程上按源树特征类先序遍历一次，写入扁平的列存储；
+ * SnapshotTree / UiSnapshotQuery 在快照上复用 SelectorEngine，可在工作线程执行。
+ */
+
+#include "UiSceneSnapshot.h"
+
+#include <QFuture>
+#include <QMetaObject>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace {
+static void setError(QString* error, const QString& msg)
+{
+    if (error) *error = msg;
+}
+static void clearError(QString* error)
+{
+    if (error) error->clear();
+}
+}  // namespace
+
+// ════════════════════════════════════════════════════════════════
+//  采集
+// ════════════════════════════════════════════════════════════════
+int UiSceneSnapshot::internType(const QObject* obj, bool classChainTypes,
+                                SelectorDetail::QmlTypeCache& cache, QHash<QByteArray, int>& ids)
+{
+    const QByteArray className(obj->metaObject()->className());
+    const auto it = ids.constFind(className);
+    if (it != ids.constEnd()) return it.value();
+
+    Type type;
+    type.className = className;
+    if (classChainTypes) {
+        // 与 WidgetTree::matchType 的继承链匹配一致
+        type.name = QString::fromLatin1(className);
+        for (const QMetaObject* m = obj->metaObject(); m; m = m->superClass())
+            type.keys.append(QString::fromLatin1(m->className()).toLower());
+    } else {
+        const SelectorDetail::QmlTypeInfo& info = cache.info(obj);
+        type.name   = info.name;
+        type.atomic = info.atomic;
+        if (!info.key.isEmpty()) type.keys.append(info.key);
+    }
+    const int id = types_.size();
+    types_.append(type);
+    ids.insert(className, id);
+    return id;
+}
+
+int UiSceneSnapshot::appendNode(QObject* obj, int parent, quint8 flags, int typeId)
+{
+    const int index = parent_.size();
+    parent_.append(parent);
+    firstChild_.append(-1);
+    nextSibling_.append(-1);
+    subtreeEnd_.append(index + 1);
+    typeIds_.append(typeId);
+    names_.append(obj->objectName());
+    flags_.append(flags);
+    objects_.append(obj);
+    return index;
+}
+
+// ────────────────────────────────────────────────────────────────
+//  capture — 单遍采集
+//
+//  1. 按 tree.children() 先序遍历所有根，下标即文档顺序；
+//     同时写入类型、名称、状态位与属性列，并串起 firstChild / nextSibling
+//  2. 自底向上回填 subtreeEnd
+//  3. 逐个遍历节点取 tree.declaredChildren()，映射为下标；
+//     不在遍历集合里的声明子节点追加到末尾（只用于兄弟判定）
+// ────────────────────────────────────────────────────────────────
+template <typename Tree>
+std::shared_ptr<const UiSceneSnapshot> UiSceneSnapshot::capture(Tree& tree, const QList<QObject*>& roots,
+                                                                const QSet<QString>& properties,
+                                                                bool classChainTypes)
+{
+    using Node = typename Tree::Node;
+
+    std::shared_ptr<UiSceneSnapshot> snap(new UiSceneSnapshot);
+    snap->properties_ = properties;
+    for (const QString& name : properties) {
+        if (name == QLatin1String("objectName")) continue; // 名称列已覆盖
+        snap->columns_.insert(name, snap->values_.size());
+        snap->values_.append(QVector<QVariant>());
+    }
+
+    tree.reset();
+    SelectorDetail::QmlTypeCache cache;
+    QHash<QByteArray, int> typeIds;
+    QHash<QObject*, int> indexOf;
+    QVector<Node> nodes;
+
+    const auto add = [&](const Node& n, int parent) {
+        QObject* obj = Tree::object(n);
+        quint8 flags = 0;
+        if (tree.isShown(n))   flags |= Shown;
+        if (tree.isEnabled(n)) flags |= Enabled;
+        if (tree.hasFocus(n))  flags |= Focused;
+        const int index = snap->appendNode(obj, parent, flags,
+                                           snap->internType(obj, classChainTypes, cache, typeIds));
+        for (auto c = snap->columns_.cbegin(); c != snap->columns_.cend(); ++c)
+            snap->values_[c.value()].append(tree.attribute(n, c.key()));
+        indexOf.insert(obj, index);
+        return index;
+    };
+
+    // 1. 先序遍历
+    struct Pending {
+        Node node;
+        int  parent;
+    };
+    QVector<int> lastChild;
+    for (QObject* rootObj : roots) {
+        const Node root = tree.fromObject(rootObj);
+        if (!root || indexOf.contains(rootObj)) continue;
+
+        QVector<Pending> stack{ Pending{ root, -1 } };
+        while (!stack.isEmpty()) {
+            const Pending p = stack.takeLast();
+            if (indexOf.contains(Tree::object(p.node))) continue;
+
+            const int index = add(p.node, p.parent);
+            nodes.append(p.node);
+            lastChild.append(-1);
+            if (p.parent < 0) {
+                snap->roots_.append(index);
+            } else {
+                const int prev = lastChild.at(p.parent);
+                if (prev < 0) snap->firstChild_[p.parent] = index;
+                else          snap->nextSibling_[prev]    = index;
+                lastChild[p.parent] = index;
+            }
+
+            const QVector<Node> kids = tree.children(p.node);
+            for (int i = kids.size() - 1; i >= 0; --i) stack.append(Pending{ kids.at(i), index });
+        }
+    }
+    snap->treeSize_ = snap->parent_.size();
+
+    // 2. 子节点下标总大于父节点，倒序一遍即可
+    for (int i = snap->treeSize_ - 1; i >= 0; --i) {
+        const int p = snap->parent_.at(i);
+        if (p >= 0) snap->subtreeEnd_[p] = qMax(snap->subtreeEnd_.at(p), snap->subtreeEnd_.at(i));
+    }
+
+    // 3. 声明顺序
+    QVector<QVector<int>> declared(snap->treeSize_);
+    for (int i = 0; i < snap->treeSize_; ++i) {
+        for (const Node& child : tree.declaredChildren(nodes.at(i))) {
+            int index = indexOf.value(Tree::object(child), -1);
+            if (index < 0) index = add(child, i);
+            declared[i].append(index);
+        }
+    }
+    snap->declStart_.reserve(snap->parent_.size() + 1);
+    for (int i = 0; i < snap->parent_.size(); ++i) {
+        snap->declStart_.append(snap->declList_.size());
+        if (i < snap->treeSize_) snap->declList_ += declared.at(i);
+    }
+    snap->declStart_.append(snap->declList_.size());
+    return snap;
+}
+
+template std::shared_ptr<const UiSceneSnapshot>
+UiSceneSnapshot::capture<QuickTree>(QuickTree&, const QList<QObject*>&, const QSet<QString>&, bool);
+template std::shared_ptr<const UiSceneSnapshot>
+UiSceneSnapshot::capture<WidgetTree>(WidgetTree&, const QList<QObject*>&, const QSet<QString>&, bool);
+template std::shared_ptr<const UiSceneSnapshot>
+UiSceneSnapshot::capture<ObjectTree>(ObjectTree&, const QList<QObject*>&, const QSet<QString>&, bool);
+
+QVariant UiSceneSnapshot::value(int n, const QString& name) const
+{
+    if (name == QLatin1String("objectName")) return names_.at(n);
+    const int column = columns_.value(name, -1);
+    return column < 0 ? QVariant() : values_.at(column).at(n);
+}
+
+QJsonObject UiSceneSnapshot::describe(int n) const
+{
+    QJsonObject out;
+    out.insert(QStringLiteral("objectName"), names_.at(n));
+    out.insert(QStringLiteral("className"), QString::fromUtf8(type(n).className));
+    const QVariant text = value(n, QStringLiteral("text"));
+    if (text.isValid()) {
+        out.insert(QStringLiteral("text"), QJsonValue::fromVariant(text));
+    }
+    const QVariant title = value(n, QStringLiteral("title"));
+    if (title.isValid()) {
+        out.insert(QStringLiteral("title"), QJsonValue::fromVariant(title));
+    }
+    const QVariant visible = value(n, QStringLiteral("visible"));
+    if (visible.isValid()) {
+        out.insert(QStringLiteral("visible"), visible.toBool());
+    }
+    return out;
+}
+
+// ════════════════════════════════════════════════════════════════
+//  SnapshotTree
+// ════════════════════════════════════════════════════════════════
+QVector<SnapshotTree::Node> SnapshotTree::children(const Node& n) const
+{
+    QVector<Node> result;
+    for (int c = snap_->firstChild(n.index); c >= 0; c = snap_->nextSibling(c))
+        result.append(Node{ c });
+    return result;
+}
+
+QVector<SnapshotTree::Node> SnapshotTree::declaredChildren(const Node& n) const
+{
+    const QVector<int>& list = snap_->declared();
+    const int end = snap_->declaredBegin(n.index + 1);
+    QVector<Node> result;
+    result.reserve(end - snap_->declaredBegin(n.index));
+    for (int i = snap_->declaredBegin(n.index); i < end; ++i) result.append(Node{ list.at(i) });
+    return result;
+}
+
+void SnapshotTree::addTypeKeys(const Node& n, BloomFilter& bf) const
+{
+    for (const QString& key : snap_->type(n.index).keys) bf.add(key);
+}
+
+bool SnapshotTree::descendInto(const Node& n, const SelectorChain& chain) const
+{
+    const UiSceneSnapshot::Type& type = snap_->type(n.index);
+    return !type.atomic || SelectorDetail::chainMentionsType(chain, type.keys.value(0));
+}
+
+// ════════════════════════════════════════════════════════════════
+//  UiSnapshotQuery
+// ════════════════════════════════════════════════════════════════
+UiSnapshotQuery::UiSnapshotQuery(std::shared_ptr<const UiSceneSnapshot> snapshot)
+    : snapshot_(std::move(snapshot))
+{
+    engine_.tree().setSnapshot(snapshot_.get());
+}
+
+bool UiSnapshotQuery::requiredProperties(const QString& selector, QSet<QString>* properties,
+                                         QString* error)
+{
+    if (selector.trimmed().isEmpty()) {
+        setError(error, QStringLiteral("querySnapshot: 选择器为空"));
+        return false;
+    }
+    try {
+        SelectorParser parser;
+        SelectorDependencies deps;
+        QStringList parts = splitSelectorList(selector);
+        if (parts.isEmpty()) parts.append(selector.trimmed());
+        for (const QString& part : parts)
+            collectDependencies(parser.parse(part), deps);
+        properties->unite(deps.properties);
+        clearError(error);
+        return true;
+    } catch (const SelectorParseError& e) {
+        setError(error, QString::fromStdString(e.what()));
+        return false;
+    }
+}
+
+bool UiSnapshotQuery::compile(const QString& selector, QList<SelectorChain>* chains, QString* error)
+{
+    if (selector.trimmed().isEmpty()) {
+        setError(error, QStringLiteral("querySnapshot: 选择器为空"));
+        return false;
+    }
+    try {
+        QStringList parts = splitSelectorList(selector);
+        if (parts.isEmpty()) parts.append(selector.trimmed());
+        SelectorDependencies deps;
+        for (const QString& part : parts) {
+            chains->append(parser_.parse(part)); // 可能抛异常
+            collectDependencies(chains->last(), deps);
+        }
+        for (const QString& name : qAsConst(deps.properties)) {
+            if (name != QLatin1String("objectName") && !snapshot_->properties().contains(name)) {
+                setError(error, QString("querySnapshot: 快照未采集属性 '%1'").arg(name));
+                return false;
+            }
+        }
+        return true;
+    } catch (const SelectorParseError& e) {
+        setError(error, QString::fromStdString(e.what()));
+        return false;
+    }
+}
+
+// ────────────────────────────────────────────────────────────────
+//  querySelectorAll — 多个根视为按顺序拼接的一棵树
+//
+//  offset 跨根消耗，每个根只收集到 "剩余 offset + 剩余 limit" 个
+//  命中即停止。快照不变，引擎缓存在各根之间共用。
+// ────────────────────────────────────────────────────────────────
+int UiSnapshotQuery::querySelectorAll(const QString& selector, const SelectorRange& range,
+                                      QVector<int>* results, QString* error)
+{
+    QList<SelectorChain> chains;
+    if (!compile(selector, &chains, error)) return -1;
+
+    try {
+        engine_.reset();
+        const QVector<int> owners(chains.size(), 0);
+        int skip  = qMax(0, range.offset);
+        int taken = 0;
+        for (const int root : snapshot_->roots()) {
+            const int budget = range.limit > 0 ? skip + range.limit - taken : 0;
+            QVector<SnapshotNode> nodes;
+            int hits = 0;
+            if (chains.size() == 1) {
+                hits = engine_.collect(SnapshotNode{ root }, chains.first(), results ? &nodes : nullptr, 0, budget);
+            } else {
+                QVector<QVector<SnapshotNode>> branches;
+                hits = engine_.collectMulti(SnapshotNode{ root }, chains, owners, 1,
+                                            results ? &branches : nullptr, 0, budget).first();
+                if (results) nodes = branches.first();
+            }
+
+            const int dropped = qMin(skip, hits);
+            skip  -= dropped;
+            taken += hits - dropped;
+            if (results) {
+                for (int i = dropped; i < nodes.size(); ++i) results->append(nodes.at(i).index);
+            }
+            if (range.limit > 0 && taken >= range.limit) break;
+        }
+        clearError(error);
+        return taken;
+    } catch (const std::exception& e) {
+        setError(error, QString("querySnapshot: 内部错误: %1").arg(e.what()));
+        return -1;
+    }
+}
+
+// ────────────────────────────────────────────────────────────────
+//  并行扫描
+//
+//  scanChunks 把 [0, count) 切块提交到线程池，按块顺序拼接结果。
+//  线程池只有一个线程（或节点太少）时直接在调用线程扫描。
+// ────────────────────────────────────────────────────────────────
+namespace {
+template <typename Scan>
+QVector<int> scanChunks(int count, QThreadPool* pool, const Scan& scan)
+{
+    const int threads = qMax(1, pool->maxThreadCount());
+    const int chunks  = qMin(count, threads * UiSnapshotQuery::kChunksPerThread);
+    if (threads == 1 || chunks <= 1) return scan(0, count);
+
+    QVector<QFuture<QVector<int>>> futures;
+    futures.reserve(chunks);
+    for (int c = 0; c < chunks; ++c) {
+        const int begin = int(qint64(count) * c / chunks);
+        const int end   = int(qint64(count) * (c + 1) / chunks);
+        futures.append(QtConcurrent::run(pool, [&scan, begin, end]() { return scan(begin, end); }));
+    }
+    QVector<int> hits;
+    for (QFuture<QVector<int>>& f : futures) hits += f.result();
+    return hits;
+}
+
+// 集中式 DFS 不会进入 descendInto() 为 false 的节点的子树，
+// 扁平扫描逐个检查命中节点的祖先链来保持同样的结果
+bool reachable(const SnapshotTree& tree, int node, const SelectorChain& chain)
+{
+    const UiSceneSnapshot& snap = *tree.snapshot();
+    for (int p = snap.parent(node); p >= 0; p = snap.parent(p)) {
+        if (snap.type(p).atomic && !tree.descendInto(SnapshotNode{ p }, chain)) return false;
+    }
+    return true;
+}
+}  // namespace
+
+int UiSnapshotQuery::querySelectorAllParallel(const QString& selector, const SelectorRange& range,
+                                              QVector<int>* results, QString* error, QThreadPool* pool)
+{
+    QList<SelectorChain> chains;
+    if (!compile(selector, &chains, error)) return -1;
+    if (!pool) pool = QThreadPool::globalInstance();
+
+    const UiSceneSnapshot* snap = snapshot_.get();
+    QVector<int> hits;
+    try {
+        hits = scanChunks(snap->treeSize(), pool, [snap, &chains](int begin, int end) {
+            SelectorEngine<SnapshotTree> engine;
+            engine.tree().setSnapshot(snap);
+            QVector<int> found;
+            for (int i = begin; i < end; ++i) {
+                const SnapshotNode n{ i };
+                for (const SelectorChain& chain : chains) {
+                    if (engine.matches(n, chain) && reachable(engine.tree(), i, chain)) {
+                        found.append(i); // 逗号分支任一命中即可，不重复
+                        break;
+                    }
+                }
+            }
+            return found;
+        });
+    } catch (const std::exception& e) {
+        setError(error, QString("querySnapshot: 内部错误: %1").arg(e.what()));
+        return -1;
+    }
+
+    const int skip  = qBound(0, range.offset, hits.size());
+    const int count = range.limit > 0 ? qMin(range.limit, hits.size() - skip) : hits.size() - skip;
+    if (results) results->append(hits.mid(skip, count));
+    clearError(error);
+    return count;
+}
+
+int UiSnapshotQuery::findText(const QString& value, const QStringList& properties,
+                              QVector<int>* results, QThreadPool* pool, const TextMatch& match) const
+{
+    // objectName 不在属性列里，单独比对名称列
+    const bool byName = properties.contains(QStringLiteral("objectName"));
+    QVector<const QVector<QVariant>*> columns;
+    for (const QString& name : properties) {
+        const int column = snapshot_->column(name);
+        if (column >= 0) columns.append(&snapshot_->columnValues(column));
+    }
+
+    const UiSceneSnapshot& snap = *snapshot_;
+    const auto hit = [&value, &match](const QString& current) {
+        return match.contains ? current.contains(value, match.cs)
+                              : current.compare(value, match.cs) == 0;
+    };
+    const auto scan = [&snap, byName, &columns, &hit](int begin, int end) {
+        QVector<int> found;
+        for (int i = begin; i < end; ++i) {
+            if (byName && hit(snap.objectName(i))) {
+                found.append(i);
+                continue;
+            }
+            for (const QVector<QVariant>* column : columns) {
+                const QVariant& v = column->at(i);
+                if (v.isValid() && hit(v.toString())) {
+                    found.append(i);
+                    break;
+                }
+            }
+        }
+        return found;
+    };
+    const QVector<int> hits = pool ? scanChunks(snapshot_->treeSize(), pool, scan)
+                                   : scan(0, snapshot_->treeSize());
+
+    const int skip  = qBound(0, match.range.offset, hits.size());
+    const int count = match.range.limit > 0 ? qMin(match.range.limit, hits.size() - skip) : hits.size() - skip;
+    if (results) results->append(hits.mid(skip, count));
+    return count;
+}
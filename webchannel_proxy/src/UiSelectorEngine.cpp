@@ -0,0 +1,370 @@
+/**
+ * UiSelectorEngine.cpp  —  Qt 5.15.x
+ *
+ * SelectorEngine<Tree> 的树特征类实现与共享工具：
+ *   · SelectorDetail：类名还原、三级属性读取、属性条件判定、QML 类型缓存
+ *   · ObjectTree / WidgetTree / QuickTree：各自的遍历与类型判定
+ */
+
+#include "UiSelectorEngine.h"
+
+#include <QMetaObject>
+#include <QMetaProperty>
+#include <QRegularExpression>
+
+#include <cstring>
+
+#include <QtQml/QQmlProperty>
+#include <QtQuick/QQuickItem>
+#include <QtGui/QWindow>
+
+namespace SelectorDetail {
+
+// ════════════════════════════════════════════════════════════════
+//  resolveQmlTypeName — 将 C++ 元对象类名还原为 QML 组件名
+//
+//  Qt 5.15 中 QML 运行时会为每个组件类型生成一个 C++ 类，
+//  其 metaObject()->className() 带有两种动态后缀：
+//
+//    _QMLTYPE_\d+   内联或文件级自定义组件
+//                    例: "MyButton_QMLTYPE_42"
+//    _QML_\d+       匿名/动态创建组件（Component.createObject 等）
+//                    例: "QQuickRectangle_QML_7"
+//
+//  Qt Quick / Qt Quick Controls 2 的所有内建控件均以 "QQuick" 开头：
+//    QQuickTextField → TextField
+//    QQuickComboBox  → ComboBox
+//    QQuickColumnLayout → ColumnLayout
+//
+//  处理步骤：
+//    Step 1  用 QRegularExpression 去掉 _(QMLTYPE|QML)_\d+ 后缀
+//            正则锚定在字符串末尾（$），保证只截断真正的后缀，
+//            不误伤名称中间恰好含有 _QML_ 的第三方组件名。
+//    Step 2  若剩余名以 "QQuick" 开头则去掉该前缀（长度 6）
+// ════════════════════════════════════════════════════════════════
+QString resolveQmlTypeName(const char* className)
+{
+    QString name = QString::fromLatin1(className);
+
+    static const QRegularExpression suffixRe(QStringLiteral("_(QMLTYPE|QML)_\\d+$"));
+    name.remove(suffixRe);
+
+    if (name.startsWith(QLatin1String("QQuick")))
+        name = name.mid(6);
+    return name;
+}
+
+// ════════════════════════════════════════════════════════════════
+//  readProperty — 读取节点属性值（三级回退）
+//
+//  Level 1 — QMetaProperty（Q_PROPERTY 静态属性），速度最快
+//  Level 2 — QObject::property()（setProperty() 添加的动态属性）
+//  Level 3 — QQmlProperty（仅通过 QML 类型系统暴露的属性 / attached property）
+//
+//  三级均不命中时返回无效的 QVariant，matchToken() 将视为不匹配。
+// ════════════════════════════════════════════════════════════════
+QVariant readProperty(QObject* obj, const QString& name)
+{
+    if (!obj || name.isEmpty()) return {};
+    const QByteArray ba = name.toLatin1();
+
+    // Level 1: Q_PROPERTY
+    const QMetaObject* mo = obj->metaObject();
+    const int idx = mo->indexOfProperty(ba.constData());
+    if (idx >= 0) {
+        const QVariant v = mo->property(idx).read(obj);
+        if (v.isValid()) return v;
+    }
+
+    // Level 2: 动态属性
+    {
+        const QVariant v = obj->property(ba.constData());
+        if (v.isValid()) return v;
+    }
+
+    // Level 3: QQmlProperty
+    {
+        QQmlProperty qp(obj, name);
+        if (qp.isValid()) return qp.read();
+    }
+    return {};
+}
+
+bool matchAttribute(const QVariant& value, const AttributeCondition& cond)
+{
+    if (!value.isValid()) return false;
+    if (cond.op.isEmpty()) return true; // 存在性检查通过
+
+    const QString sv = value.toString().trimmed();
+    if (cond.op == QLatin1String("="))  return sv == cond.value;
+    if (cond.op == QLatin1String("~="))
+        return sv.split(QChar(' '), QString::SkipEmptyParts).contains(cond.value);
+    if (cond.op == QLatin1String("^=")) return sv.startsWith(cond.value);
+    if (cond.op == QLatin1String("$=")) return sv.endsWith(cond.value);
+    if (cond.op == QLatin1String("*=")) return sv.contains(cond.value);
+    if (cond.op == QLatin1String("|=")) return sv == cond.value || sv.startsWith(cond.value + '-');
+    return false;
+}
+
+// ────────────────────────────────────────────────────────────────
+//  QmlTypeCache::info
+//
+//  原子容器策略：自定义组件（_QMLTYPE_）默认不进入内部，
+//  容器型（Item/Rectangle/布局/视图等）除外。
+// ────────────────────────────────────────────────────────────────
+const QmlTypeInfo& QmlTypeCache::info(const QObject* obj)
+{
+    const QMetaObject* mo = obj->metaObject();
+    const char* className = mo->className();
+    const QByteArray key = QByteArray::fromRawData(className, int(qstrlen(className)));
+
+    const auto it = cache_.constFind(key);
+    if (it != cache_.constEnd()) return it.value();
+
+    static const QSet<QString> containerTypes = {
+        "Item", "Rectangle", "Column", "Row", "Grid", "Flow",
+        "Flickable", "ListView", "GridView", "Repeater", "Component"
+    };
+
+    QmlTypeInfo info;
+    info.name   = resolveQmlTypeName(className);
+    info.key    = info.name.toLower();
+    info.isItem = mo->inherits(&QQuickItem::staticMetaObject);
+    info.atomic = std::strstr(className, "_QMLTYPE_") && !containerTypes.contains(info.name);
+    info.visibleProp = mo->indexOfProperty("visible");
+    info.enabledProp = mo->indexOfProperty("enabled");
+    info.focusProp   = mo->indexOfProperty("activeFocus");
+    return cache_.insert(QByteArray(className), info).value();
+}
+
+// 链中有通配符或显式引用 key 类型时，才进入原子容器内部
+bool chainMentionsType(const SelectorChain& chain, const QString& key)
+{
+    for (const SelectorSegment& seg : chain) {
+        if (seg.token.typeKey.isEmpty() || seg.token.typeKey == key)
+            return true;
+    }
+    return false;
+}
+
+bool readBoolProperty(QObject* obj, int index, bool fallback)
+{
+    if (index < 0) return fallback;
+    const QVariant v = obj->metaObject()->property(index).read(obj);
+    return v.isValid() ? v.toBool() : fallback;
+}
+
+bool hasPseudo(const SelectorToken& token, PseudoClass::Type type)
+{
+    for (const PseudoClass& pc : token.pseudos) {
+        if (pc.type == type) return true;
+    }
+    return false;
+}
+
+}  // namespace SelectorDetail
+
+// ════════════════════════════════════════════════════════════════
+//  ObjectTree
+// ════════════════════════════════════════════════════════════════
+QVector<ObjectTree::Node> ObjectTree::children(Node n) const
+{
+    const QObjectList& kids = n->children();
+    return QVector<Node>(kids.cbegin(), kids.cend());
+}
+
+bool ObjectTree::matchType(Node n, const SelectorToken& token) const
+{
+    return types_.info(n).key == token.typeKey;
+}
+
+void ObjectTree::addTypeKeys(Node n, BloomFilter& bf) const
+{
+    const QString key = types_.info(n).key;
+    if (!key.isEmpty()) bf.add(key);
+}
+
+bool ObjectTree::descendInto(Node n, const SelectorChain& chain) const
+{
+    const SelectorDetail::QmlTypeInfo& info = types_.info(n);
+    return !info.atomic || SelectorDetail::chainMentionsType(chain, info.key);
+}
+
+QString ObjectTree::typeLabel(Node n) const
+{
+    return types_.info(n).name;
+}
+
+bool ObjectTree::isShown(Node n) const
+{
+    return SelectorDetail::readBoolProperty(n, types_.info(n).visibleProp, true);
+}
+
+bool ObjectTree::isEnabled(Node n) const
+{
+    return SelectorDetail::readBoolProperty(n, types_.info(n).enabledProp, true);
+}
+
+bool ObjectTree::hasFocus(Node n) const
+{
+    return SelectorDetail::readBoolProperty(n, types_.info(n).focusProp, false);
+}
+
+// ════════════════════════════════════════════════════════════════
+//  WidgetTree
+//
+//  QObject::children() 中的 QLayout、QButtonGroup、QAction 等
+//  非控件对象不属于控件层级，既不参与遍历也不计入兄弟顺序。
+// ════════════════════════════════════════════════════════════════
+QVector<WidgetTree::Node> WidgetTree::children(Node n) const
+{
+    QVector<Node> result;
+    for (QObject* child : n->children()) {
+        if (child->isWidgetType()) result.append(static_cast<QWidget*>(child));
+    }
+    return result;
+}
+
+const QVector<QString>& WidgetTree::classChain(Node n) const
+{
+    const QMetaObject* mo = n->metaObject();
+    auto it = chains_.find(mo);
+    if (it == chains_.end()) {
+        QVector<QString> chain;
+        for (const QMetaObject* m = mo; m; m = m->superClass())
+            chain.append(QString::fromLatin1(m->className()).toLower());
+        it = chains_.insert(mo, chain);
+    }
+    return it.value();
+}
+
+bool WidgetTree::matchType(Node n, const SelectorToken& token) const
+{
+    return classChain(n).contains(token.typeKey);
+}
+
+void WidgetTree::addTypeKeys(Node n, BloomFilter& bf) const
+{
+    // 与 matchType 的继承链匹配保持一致
+    for (const QString& key : classChain(n)) bf.add(key);
+}
+
+QString WidgetTree::typeLabel(Node n) const
+{
+    return QString::fromLatin1(n->metaObject()->className());
+}
+
+// ════════════════════════════════════════════════════════════════
+//  QuickTree
+// ════════════════════════════════════════════════════════════════
+QuickTree::Node QuickTree::fromObject(QObject* obj) const
+{
+    if (!obj) return {};
+    return { obj, types_.info(obj).isItem ? static_cast<QQuickItem*>(obj) : nullptr };
+}
+
+QVector<QuickTree::Node> QuickTree::children(const Node& n) const
+{
+    QVector<Node> result;
+    if (n.item) {
+        const QList<QQuickItem*> items = n.item->childItems();
+        result.reserve(items.size());
+        for (QQuickItem* child : items) result.append(QuickNode{ child, child });
+
+        // QWindow 子对象（如 CusMaskLayer）不在可视树里，单独补上
+        for (QObject* child : n.object->children()) {
+            if (child->isWindowType()) result.append(QuickNode{ child, nullptr });
+        }
+        return result;
+    }
+
+    const QObjectList& kids = n.object->children();
+    result.reserve(kids.size());
+    for (QObject* child : kids) result.append(fromObject(child));
+    return result;
+}
+
+// ────────────────────────────────────────────────────────────────
+//  declaredChildren — 基于 QObject::children()，反映 QML 源码的声明顺序
+//
+//  QObject::children() 为空时回退到可视子节点，
+//  保证 Item 仅有视觉子项时仍能做兄弟判定。
+// ────────────────────────────────────────────────────────────────
+QVector<QuickTree::Node> QuickTree::declaredChildren(const Node& n) const
+{
+    QVector<Node> result;
+    const QObjectList& kids = n.object->children();
+    result.reserve(kids.size());
+    for (QObject* child : kids) result.append(fromObject(child));
+    if (!result.isEmpty()) return result;
+    return children(n);
+}
+
+// ────────────────────────────────────────────────────────────────
+//  parent — 逻辑父节点
+//
+//    1. QObject 父对象不是 Item 的 Item：经 children() 从该对象进入可视树
+//       （如 QQuickWindow::contentItem），取 QObject::parent()，与遍历路径一致
+//    2. 其他 Item：parentItem()（QObject::parent() 可能为空）
+//    3. 回退到 QObject::parent()
+//  只由节点自身决定，与遍历是否已经到过它无关（RTL / :visible 记忆化依赖这一点）
+// ────────────────────────────────────────────────────────────────
+QuickTree::Node QuickTree::parent(const Node& n) const
+{
+    if (!n) return {};
+    QObject* objectParent = n.object->parent();
+    const bool boundary = objectParent && !types_.info(objectParent).isItem;
+    if (n.item && !boundary) {
+        if (QQuickItem* p = n.item->parentItem()) return { p, p };
+    }
+    return fromObject(objectParent);
+}
+
+bool QuickTree::matchType(const Node& n, const SelectorToken& token) const
+{
+    return types_.info(n.object).key == token.typeKey;
+}
+
+void QuickTree::addTypeKeys(const Node& n, BloomFilter& bf) const
+{
+    const QString key = types_.info(n.object).key;
+    if (!key.isEmpty()) bf.add(key);
+}
+
+bool QuickTree::descendInto(const Node& n, const SelectorChain& chain) const
+{
+    const SelectorDetail::QmlTypeInfo& info = types_.info(n.object);
+    return !info.atomic || SelectorDetail::chainMentionsType(chain, info.key);
+}
+
+QString QuickTree::typeLabel(const Node& n) const
+{
+    return types_.info(n.object).name;
+}
+
+// ────────────────────────────────────────────────────────────────
+//  状态伪类
+//
+//  QQuickItem::isVisible() / isEnabled() 本身已是 Item 树内的有效值；
+//  关闭的 Popup 不是 Item，靠它自身的 visible 属性把整棵内容树剪掉。
+// ────────────────────────────────────────────────────────────────
+bool QuickTree::isShown(const Node& n) const
+{
+    if (n.item) return n.item->isVisible();
+    if (n.object->isWindowType()) return static_cast<QWindow*>(n.object)->isVisible();
+    return SelectorDetail::readBoolProperty(n.object, types_.info(n.object).visibleProp, true);
+}
+
+bool QuickTree::isEnabled(const Node& n) const
+{
+    if (n.item) return n.item->isEnabled();
+    if (n.object->isWindowType()) return true;
+    return SelectorDetail::readBoolProperty(n.object, types_.info(n.object).enabledProp, true);
+}
+
+bool QuickTree::hasFocus(const Node& n) const
+{
+    if (n.item) return n.item->hasActiveFocus();
+    if (n.object->isWindowType()) return static_cast<QWindow*>(n.object)->isActive();
+    return SelectorDetail::readBoolProperty(n.object, types_.info(n.object).focusProp, false);
+}
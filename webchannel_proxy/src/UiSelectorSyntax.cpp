@@ -0,0 +1,622 @@
+/**
+ * UiSelectorSyntax.cpp  —  Qt 5.15.x
+ *
+ * 选择器语法层：顶层逗号拆分 + 单条选择器的递归下降解析。
+ * 从 UiQMLQuery.cpp 拆出，与节点树类型无关，
+ * QmlQuerySelector 与 SelectorEngine<Tree> 共用。
+ */
+
+ #include "UiSelectorSyntax.h"
+
+ // ────────────────────────────────────────────────────────────────
+ //  splitSelectorList — 将顶层逗号分隔的复合选择器拆分为子选择器列表
+ //
+ //  规则：只在「括号深度为 0」时将逗号视为分隔符，
+ //        跳过属性选择器 [...] 与 :not(...) / :has(...) 参数内部的逗号，
+ //        避免误拆 Button[title='a,b']、Row:has(Label, Text) 这类选择器。
+ //
+ //  示例：
+ //    "Rectangle, Button[text='a,b'], Text"
+ //      → ["Rectangle", "Button[text='a,b']", "Text"]
+ // ────────────────────────────────────────────────────────────────
+ QStringList splitSelectorList(const QString& selector)
+ {
+     QStringList parts;
+     QString current;
+     int depth = 0;
+     for (const QChar ch : selector) {
+         if      (ch == '[' || ch == '(')  { ++depth; current += ch; }
+         else if (ch == ']' || ch == ')')  { --depth; current += ch; }
+         else if (ch == ',' && depth == 0) { const QString p = current.trimmed();
+                                             if (!p.isEmpty()) parts.append(p);
+                                             current.clear(); }
+         else                              { current += ch; }
+     }
+     const QString last = current.trimmed();
+     if (!last.isEmpty()) parts.append(last);
+     return parts;
+ }
+
+ // ════════════════════════════════════════════════════════════════
+ //  解析阶段 — 整体选择器链（逗号已由外层剔除）
+ // ════════════════════════════════════════════════════════════════
+ // ════════════════════════════════════════════════════════════════
+ //  parse — 将单条选择器字符串（不含顶层逗号）解析为 SelectorChain
+ //
+ //  逐字符扫描，识别三类元素：
+ //    · 空白          → Combinator::Descendant（后代组合器）
+ //    · > + ~         → 对应的显式组合器
+ //    · 其他字符串    → token 文本，截取后交给 parseToken()
+ //
+ //  括号深度追踪（depth）确保 [...] 和 (...) 内部的组合器字符
+ //  不被误当作分隔符处理。
+ //
+ //  解析结果缓存在 cache_ 中，相同选择器字符串只解析一次。
+ // ════════════════════════════════════════════════════════════════
+ SelectorChain SelectorParser::parse(const QString& selector)
+ {
+     if (cache_.contains(selector))
+         return cache_.value(selector);
+
+     const SelectorChain chain = parseChain(selector, /*relative=*/false);
+     cache_.insert(selector, chain);
+     return chain;
+ }
+
+ // ────────────────────────────────────────────────────────────────
+ //  parseChain — parse() 的实际实现，不经过缓存
+ //
+ //  relative = true 用于 :has(...) 的相对选择器：允许以组合器开头，
+ //  如 ":has(> Label)"，首段的组合器描述它与锚点节点的关系；
+ //  省略时为 Descendant。
+ // ────────────────────────────────────────────────────────────────
+ SelectorChain SelectorParser::parseChain(const QString& selector, bool relative)
+ {
+     SelectorChain chain;
+ 
+     // 将选择器字符串分割为 [combinator?, tokenSrc] 序列
+     // 策略：逐字符扫描，遇到组合器字符或空白则切分
+     const QString s = selector.trimmed();
+     int pos = 0;
+     const int len = s.length();
+ 
+     Combinator pendingComb = Combinator::Descendant;
+     bool firstToken = true;
+ 
+     while (pos < len) {
+         const QChar ch = s[pos];
+ 
+         // ── 跳过空白，空白本身是 Descendant 组合器 ──────────
+         if (ch.isSpace()) {
+             if (!firstToken && pendingComb == Combinator::Descendant)
+                 pendingComb = Combinator::Descendant; // 已默认，保持
+             ++pos;
+             // 空白后可能跟着 >, +, ~ 组合器，需要继续读
+             while (pos < len && s[pos].isSpace()) ++pos;
+             continue;
+         }
+ 
+         // ── 显式组合器 ───────────────────────────────────────
+         if (ch == '>' || ch == '+' || ch == '~') {
+             if      (ch == '>') pendingComb = Combinator::Child;
+             else if (ch == '+') pendingComb = Combinator::Adjacent;
+             else                pendingComb = Combinator::Sibling;
+             ++pos;
+             while (pos < len && s[pos].isSpace()) ++pos;
+             continue;
+         }
+ 
+         // ── Token ────────────────────────────────────────────
+         // 截取从 pos 到下一个顶层组合器之间的文本，交给 parseToken
+         // 需要跳过 [...] 和 (...) 内部的组合器字符
+         int tokenStart = pos;
+         int depth = 0;
+         while (pos < len) {
+             const QChar c = s[pos];
+             if      (c == '[' || c == '(') { ++depth; ++pos; }
+             else if (c == ']' || c == ')') { --depth; ++pos; }
+             else if (depth == 0 && (c.isSpace() || c == '>' || c == '+' || c == '~'))
+                 break;
+             else ++pos;
+         }
+ 
+         const QString tokenSrc = s.mid(tokenStart, pos - tokenStart).trimmed();
+         if (tokenSrc.isEmpty()) continue;
+ 
+         int tpos = 0;
+         SelectorSegment seg;
+         seg.token      = parseToken(tokenSrc, tpos); // 可能抛 SelectorParseError
+         seg.combinator = firstToken && !relative ? Combinator::Descendant : pendingComb;
+         chain.append(seg);
+         firstToken  = false;
+         pendingComb = Combinator::Descendant;
+     }
+
+     return chain;
+ }
+
+QString SelectorParser::debugParse(const QString& selector)
+{
+    QString out;
+    SelectorChain chain = parse(selector);
+    for (int i = 0; i < chain.size(); ++i) {
+        const SelectorSegment& seg = chain[i];
+        out += QString("[%1] comb=%2 type=%3").arg(i)
+            .arg((int)seg.combinator)
+            .arg(seg.token.typeName.isEmpty() ? QStringLiteral("*") : seg.token.typeName);
+        if (!seg.token.attributes.isEmpty()) out += " attrs";
+        if (!seg.token.pseudos.isEmpty()) out += " pseudos";
+        out += "\n";
+    }
+    return out;
+}
+
+ 
+ // ════════════════════════════════════════════════════════════════
+ //  Token 递归下降解析器
+ //
+ //  Grammar:
+ //    token        := type_part modifier*
+ //    type_part    := IDENT | '*' | ε
+ //    modifier     := attr_selector | pseudo_class
+ //    attr_selector:= '[' IDENT (op value)? ']'
+ //    pseudo_class := ':' pseudo_name '(' nth_expr ')' | ':' state_name
+ //                  | ':' ('not' | 'has') '(' selector_list ')'
+ //    pseudo_name  := 'nth-child' | 'nth-last-child'
+ //    state_name   := 'visible' | 'enabled' | 'focused' | 'first-child' | 'last-child'
+ //    nth_expr     := 'odd' | 'even' | INTEGER | [+-]? INTEGER? 'n' ([+-] INTEGER)?
+ //    op           := '=' | '~=' | '^=' | '$=' | '*=' | '|='
+ //    value        := QUOTED_STRING | UNQUOTED_VALUE
+ // ════════════════════════════════════════════════════════════════
+ // ════════════════════════════════════════════════════════════════
+ //  parseToken — 单个 token 的递归下降解析入口
+ //
+ //  Grammar:
+ //    token     := type_part modifier*
+ //    type_part := IDENT        QML 类型名，如 "TextField"
+ //               | '*'          显式通配符
+ //               | ε            省略类型名，等价于通配符
+ //    modifier  := attr_selector | pseudo_class
+ //
+ //  pos 为当前解析位置（in/out），解析完毕后指向 token 结束位置。
+ //  语法错误时抛出 SelectorParseError，携带出错位置和原因。
+ // ════════════════════════════════════════════════════════════════
+ SelectorToken SelectorParser::parseToken(const QString& src, int& pos)
+ {
+     SelectorToken token;
+     skipSpaces(src, pos);
+ 
+     if (pos >= src.length()) return token; // 空串 → 通配符
+ 
+     const QChar first = src[pos];
+ 
+     // ── type_part ────────────────────────────────────────────
+     if (first == '*') {
+         ++pos;                       // 显式通配符，typeName 留空
+     } else if (first == '[' || first == ':') {
+         // 省略类型名，也是通配符
+     } else if (first.isLetter() || first == '_') {
+         token.typeName = parseIdent(src, pos);
+         token.typeKey  = token.typeName.toLower();
+     } else {
+         throw SelectorParseError(
+             QString("parseToken: 意外字符 '%1' at pos %2 in \"%3\"")
+                 .arg(first).arg(pos).arg(src));
+     }
+ 
+     // ── modifier* ────────────────────────────────────────────
+     while (pos < src.length()) {
+         const QChar ch = src[pos];
+         if      (ch == '[') parseAttrSelector(src, pos, token);
+         else if (ch == ':') parsePseudoClass (src, pos, token);
+         else break; // 遇到其他字符（组合器等），token 解析结束
+     }
+ 
+     return token;
+ }
+ 
+ // ────────────────────────────────────────────────────────────────
+ //  attr_selector := '[' IDENT (op value)? ']'
+ // ────────────────────────────────────────────────────────────────
+ // ════════════════════════════════════════════════════════════════
+ //  parseAttrSelector — 解析属性选择器 [attr] 或 [attr op value]
+ //
+ //  Grammar:
+ //    attr_selector := '[' IDENT (op value)? ']'
+ //
+ //  支持的操作符（parseAttrOp 负责识别）：
+ //    =   精确匹配
+ //    ~=  空格分隔词中包含指定词
+ //    ^=  前缀匹配
+ //    $=  后缀匹配
+ //    *=  子串匹配
+ //    |=  等于或以"值-"开头（语言代码惯例）
+ //
+ //  省略 op 和 value 时（如 [visible]）表示「属性存在性」检查，
+ //  op 字段留空，matchToken() 对空 op 直接通过。
+ // ════════════════════════════════════════════════════════════════
+ void SelectorParser::parseAttrSelector(const QString& src, int& pos,
+                                           SelectorToken& token)
+ {
+     expect(src, pos, '[');
+     skipSpaces(src, pos);
+ 
+     AttributeCondition cond;
+     cond.name = parseIdent(src, pos);
+     if (cond.name.isEmpty())
+         throw SelectorParseError(
+             QString("parseAttrSelector: 属性名不能为空 at pos %1 in \"%2\"")
+                 .arg(pos).arg(src));
+ 
+     skipSpaces(src, pos);
+ 
+     if (pos < src.length() && src[pos] != ']') {
+         cond.op    = parseAttrOp(src, pos);
+         skipSpaces(src, pos);
+         cond.value = parseAttrValue(src, pos);
+         skipSpaces(src, pos);
+     }
+ 
+     expect(src, pos, ']');
+     token.attributes.append(cond);
+ }
+ 
+ // ────────────────────────────────────────────────────────────────
+ //  pseudo_class := ':' pseudo_name '(' nth_expr ')'
+ // ────────────────────────────────────────────────────────────────
+ // ════════════════════════════════════════════════════════════════
+ //  parsePseudoClass — 解析伪类选择器 :pseudo-name(an+b)
+ //
+ //  Grammar:
+ //    pseudo_class := ':' pseudo_name '(' nth_expr ')'
+ //                  | ':' state_name
+ //                  | ':' ('not' | 'has') '(' selector_list ')'
+ //    pseudo_name  := 'nth-child' | 'nth-last-child'
+ //    state_name   := 'visible' | 'enabled' | 'focused'
+ //                  | 'first-child' | 'last-child'
+ //
+ //  当前支持的伪类：
+ //    :nth-child(an+b)      父元素声明子列表中正数位置 a·k+b（k >= 0，1-based）
+ //    :nth-last-child(an+b) 父元素声明子列表中倒数位置 a·k+b
+ //    :first-child / :last-child  等价于 :nth-child(1) / :nth-last-child(1)
+ //    :visible           有效可见（自身及所有祖先均可见）
+ //    :enabled           可用
+ //    :focused           持有活动焦点
+ //    :not(A, B)         不匹配列表中任一选择器
+ //    :has(A, > B, + C)  存在满足相对选择器的后代 / 子节点 / 后续兄弟
+ //
+ //  纯整数参数必须 >= 1，传入 0 或负数时抛出 SelectorParseError。
+ //  遇到不支持的伪类名（如 :hover）也立即抛出错误，
+ //  避免静默匹配到错误节点。
+ // ════════════════════════════════════════════════════════════════
+ void SelectorParser::parsePseudoClass(const QString& src, int& pos,
+                                          SelectorToken& token)
+ {
+     expect(src, pos, ':');
+ 
+     const QString name = parseIdent(src, pos);
+     if (name.isEmpty())
+         throw SelectorParseError(
+             QString("parsePseudoClass: 伪类名不能为空 at pos %1 in \"%2\"")
+                 .arg(pos).arg(src));
+ 
+     PseudoClass pc;
+     pc.a = 0;
+     pc.b = 0;
+     if      (name == "nth-child")      pc.type = PseudoClass::NthChild;
+     else if (name == "nth-last-child") pc.type = PseudoClass::NthLastChild;
+     else if (name == "first-child")  { pc.type = PseudoClass::NthChild;     pc.b = 1; }
+     else if (name == "last-child")   { pc.type = PseudoClass::NthLastChild; pc.b = 1; }
+     else if (name == "visible")        pc.type = PseudoClass::Visible;
+     else if (name == "enabled")        pc.type = PseudoClass::Enabled;
+     else if (name == "focused")        pc.type = PseudoClass::Focused;
+     else if (name == "not")            pc.type = PseudoClass::Not;
+     else if (name == "has")            pc.type = PseudoClass::Has;
+     else
+         throw SelectorParseError(
+             QString("parsePseudoClass: 不支持的伪类 ':%1' at pos %2 in \"%3\"")
+                 .arg(name).arg(pos).arg(src));
+
+     // 状态伪类与 :first-child / :last-child 不带参数
+     if (pc.type == PseudoClass::Visible || pc.type == PseudoClass::Enabled
+         || pc.type == PseudoClass::Focused || pc.b != 0) {
+         token.pseudos.append(pc);
+         return;
+     }
+
+     if (pc.type == PseudoClass::Not || pc.type == PseudoClass::Has) {
+         const QString arg = parseParenthesized(src, pos);
+         auto selectors = std::make_shared<QList<SelectorChain>>();
+         for (const QString& part : splitSelectorList(arg)) {
+             const SelectorChain sub = parseChain(part, pc.type == PseudoClass::Has);
+             if (!sub.isEmpty()) selectors->append(sub);
+         }
+         if (selectors->isEmpty())
+             throw SelectorParseError(
+                 QString("parsePseudoClass: ':%1()' 参数为空 in \"%2\"").arg(name).arg(src));
+         pc.selectors = selectors;
+         token.pseudos.append(pc);
+         return;
+     }
+ 
+     parseNth(parseParenthesized(src, pos), pc);
+ 
+     token.pseudos.append(pc);
+ }
+ 
+ // ────────────────────────────────────────────────────────────────
+ //  parseNth — 解析 :nth-child / :nth-last-child 的参数
+ //
+ //  Grammar（空白忽略，大小写不敏感）：
+ //    nth_expr := 'odd' | 'even'
+ //              | [+-]? INTEGER                        纯位置，a = 0
+ //              | [+-]? INTEGER? 'n' ( [+-] INTEGER )?  a·n + b
+ //
+ //  示例：odd → 2n+1，even → 2n，-n+3 → 前三个，3n → 每第三个
+ // ────────────────────────────────────────────────────────────────
+ void SelectorParser::parseNth(const QString& arg, PseudoClass& pc)
+ {
+     QString e = arg.toLower();
+     e.remove(QChar(' '));
+     if (e == "odd")  { pc.a = 2; pc.b = 1; return; }
+     if (e == "even") { pc.a = 2; pc.b = 0; return; }
+
+     int pos = 0;
+     int sign = 1;
+     if (pos < e.length() && (e[pos] == '+' || e[pos] == '-'))
+         sign = e[pos++] == '-' ? -1 : 1;
+     const bool hasCoeff = pos < e.length() && e[pos].isDigit();
+     const int  coeff    = hasCoeff ? parseInteger(e, pos) : 1;
+
+     if (pos < e.length() && e[pos] == 'n') {
+         ++pos;
+         pc.a = sign * coeff;
+         pc.b = 0;
+         if (pos < e.length()) {
+             if (e[pos] != '+' && e[pos] != '-')
+                 throw SelectorParseError(
+                     QString("parseNth: 期望 '+' 或 '-' at pos %1 in \"%2\"").arg(pos).arg(arg));
+             const int bsign = e[pos++] == '-' ? -1 : 1;
+             pc.b = bsign * parseInteger(e, pos);
+         }
+     } else {
+         if (!hasCoeff) parseInteger(e, pos); // 抛出「期望数字」
+         pc.a = 0;
+         pc.b = sign * coeff;
+         if (pc.b < 1)
+             throw SelectorParseError(
+                 QString("parsePseudoClass: :nth 参数必须 >= 1，got %1 in \"%2\"")
+                     .arg(pc.b).arg(arg));
+     }
+
+     if (pos != e.length())
+         throw SelectorParseError(
+             QString("parseNth: 无法解析的表达式 \"%1\"").arg(arg));
+ }
+
+ // ────────────────────────────────────────────────────────────────
+ //  parseParenthesized — 读取 '(' ... ')' 之间的原文（不含括号）
+ //
+ //  计入嵌套括号，引号内的括号不计数，便于 :has(:not(...)) 与
+ //  :has(Text[text='a)b']) 这类参数。括号未闭合时抛出 SelectorParseError。
+ // ────────────────────────────────────────────────────────────────
+ QString SelectorParser::parseParenthesized(const QString& src, int& pos)
+ {
+     expect(src, pos, '(');
+     const int start = pos;
+     int depth = 1;
+     QChar quote;
+     for (; pos < src.length(); ++pos) {
+         const QChar c = src[pos];
+         if (!quote.isNull()) { if (c == quote) quote = QChar(); }
+         else if (c == '\'' || c == '"') quote = c;
+         else if (c == '(') ++depth;
+         else if (c == ')' && --depth == 0) break;
+     }
+     if (pos >= src.length())
+         throw SelectorParseError(
+             QString("parseParenthesized: 括号未闭合 in \"%1\"").arg(src));
+     const QString inner = src.mid(start, pos - start).trimmed();
+     ++pos; // 跳过 ')'
+     return inner;
+ }
+
+ // ────────────────────────────────────────────────────────────────
+ //  IDENT := [a-zA-Z_][a-zA-Z0-9_-]*
+ //  支持连字符（nth-child、my-component 等）
+ // ────────────────────────────────────────────────────────────────
+ // ════════════════════════════════════════════════════════════════
+ //  parseIdent — 解析标识符
+ //
+ //  Grammar:
+ //    IDENT := [a-zA-Z0-9_-]+
+ //
+ //  允许连字符，支持 "nth-child"、"my-component" 等名称。
+ //  遇到非标识符字符时停止，返回已读取部分（可能为空串）。
+ //  调用方负责检查返回值是否为空并决定是否抛出错误。
+ // ════════════════════════════════════════════════════════════════
+ QString SelectorParser::parseIdent(const QString& src, int& pos)
+ {
+     QString result;
+     while (pos < src.length()) {
+         const QChar ch = src[pos];
+         if (ch.isLetterOrNumber() || ch == '_' || ch == '-') {
+             result += ch;
+             ++pos;
+         } else {
+             break;
+         }
+     }
+     return result;
+ }
+ 
+ // ────────────────────────────────────────────────────────────────
+ //  op := '~=' | '^=' | '$=' | '*=' | '|=' | '='
+ //  多字符操作符优先
+ // ────────────────────────────────────────────────────────────────
+ // ════════════════════════════════════════════════════════════════
+ //  parseAttrOp — 解析属性操作符
+ //
+ //  Grammar:
+ //    op := '~=' | '^=' | '$=' | '*=' | '|=' | '='
+ //
+ //  优先尝试双字符操作符（向前看一个字符），再尝试单字符 '='。
+ //  其他字符组合视为语法错误，立即抛出 SelectorParseError。
+ // ════════════════════════════════════════════════════════════════
+ QString SelectorParser::parseAttrOp(const QString& src, int& pos)
+ {
+     if (pos >= src.length())
+         throw SelectorParseError(
+             QString("parseAttrOp: 意外结束 at pos %1 in \"%2\"").arg(pos).arg(src));
+ 
+     const QChar ch = src[pos];
+ 
+     // 双字符操作符
+     if (pos + 1 < src.length() && src[pos + 1] == '=') {
+         if (ch == '~' || ch == '^' || ch == '$' || ch == '*' || ch == '|') {
+             QString op = QString(ch) + '=';
+             pos += 2;
+             return op;
+         }
+     }
+ 
+     // 单字符 =
+     if (ch == '=') { ++pos; return "="; }
+ 
+     throw SelectorParseError(
+         QString("parseAttrOp: 未知操作符 '%1' at pos %2 in \"%3\"")
+             .arg(ch).arg(pos).arg(src));
+ }
+ 
+ // ────────────────────────────────────────────────────────────────
+ //  value := QUOTED_STRING | UNQUOTED_VALUE
+ //  QUOTED_STRING := '\'' [^']* '\'' | '"' [^"]* '"'
+ //  UNQUOTED_VALUE:= 到 ']' 之前的非空白字符
+ // ────────────────────────────────────────────────────────────────
+ // ════════════════════════════════════════════════════════════════
+ //  parseAttrValue — 解析属性值
+ //
+ //  Grammar:
+ //    value := QUOTED_STRING | UNQUOTED_VALUE
+ //    QUOTED_STRING  := '\'' [^\']* '\'' | '"' [^"]* '"'
+ //    UNQUOTED_VALUE := ( 非 ']' 非空白 )+
+ //
+ //  引号字符串：单引号或双引号均支持，内部不支持转义序列，
+ //              引号未闭合时抛出 SelectorParseError。
+ //  无引号字符串：读到 ']' 或空白为止，结果为空时抛出错误。
+ //
+ //  建议在选择器中始终使用引号包裹属性值，
+ //  以避免含空格或特殊字符的值被截断。
+ // ════════════════════════════════════════════════════════════════
+ QString SelectorParser::parseAttrValue(const QString& src, int& pos)
+ {
+     if (pos >= src.length())
+         throw SelectorParseError(
+             QString("parseAttrValue: 意外结束 at pos %1 in \"%2\"").arg(pos).arg(src));
+ 
+     const QChar quote = src[pos];
+ 
+     if (quote == '\'' || quote == '"') {
+         ++pos; // 跳过开引号
+         QString result;
+         while (pos < src.length() && src[pos] != quote) {
+             result += src[pos++];
+         }
+         if (pos >= src.length())
+             throw SelectorParseError(
+                 QString("parseAttrValue: 引号未闭合 in \"%1\"").arg(src));
+         ++pos; // 跳过闭引号
+         return result;
+     }
+ 
+     // 无引号：读到 ']' 或空白
+     QString result;
+     while (pos < src.length() && src[pos] != ']' && !src[pos].isSpace()) {
+         result += src[pos++];
+     }
+     if (result.isEmpty())
+         throw SelectorParseError(
+             QString("parseAttrValue: 属性值为空 at pos %1 in \"%2\"").arg(pos).arg(src));
+     return result;
+ }
+ 
+ // ────────────────────────────────────────────────────────────────
+ //  INTEGER := [0-9]+
+ // ────────────────────────────────────────────────────────────────
+ // ════════════════════════════════════════════════════════════════
+ //  parseInteger — 解析非负整数
+ //
+ //  Grammar:
+ //    INTEGER := [0-9]+
+ //
+ //  当前位置不是数字时立即抛出 SelectorParseError。
+ //  结果通过 QString::toInt() 转换，不检查溢出，
+ //  实际上 :nth-child 的 a / b 不会超过几百，无需特别处理。
+ // ════════════════════════════════════════════════════════════════
+ int SelectorParser::parseInteger(const QString& src, int& pos)
+ {
+     if (pos >= src.length() || !src[pos].isDigit())
+         throw SelectorParseError(
+             QString("parseInteger: 期望数字 at pos %1 in \"%2\"").arg(pos).arg(src));
+ 
+     QString digits;
+     while (pos < src.length() && src[pos].isDigit())
+         digits += src[pos++];
+ 
+     return digits.toInt();
+ }
+ 
+ // ────────────────────────────────────────────────────────────────
+ //  skipSpaces — 跳过当前位置起的连续空白字符
+ //  用于 parseAttrSelector / parsePseudoClass 中吃掉可选空白。
+ // ────────────────────────────────────────────────────────────────
+ void SelectorParser::skipSpaces(const QString& src, int& pos)
+ {
+     while (pos < src.length() && src[pos].isSpace()) ++pos;
+ }
+ 
+ // ────────────────────────────────────────────────────────────────
+ //  expect — 断言当前字符为 ch 并推进 pos
+ //
+ //  若当前位置超出字符串或字符不匹配，抛出 SelectorParseError，
+ //  错误信息包含期望字符、实际字符和位置，便于定位选择器错误。
+ // ────────────────────────────────────────────────────────────────
+ void SelectorParser::expect(const QString& src, int& pos, QChar ch)
+ {
+     if (pos >= src.length())
+         throw SelectorParseError(
+             QString("expect '%1': 意外结束 in \"%2\"").arg(ch).arg(src));
+     if (src[pos] != ch)
+         throw SelectorParseError(
+             QString("expect '%1': 实际为 '%2' at pos %3 in \"%4\"")
+                 .arg(ch).arg(src[pos]).arg(pos).arg(src));
+     ++pos;
+ }
+
+ // ────────────────────────────────────────────────────────────────
+ //  collectDependencies — 汇总选择器链依赖的属性
+ // ────────────────────────────────────────────────────────────────
+ void collectDependencies(const SelectorChain& chain, SelectorDependencies& deps)
+ {
+     for (const SelectorSegment& seg : chain) {
+         for (const AttributeCondition& cond : seg.token.attributes)
+             deps.properties.insert(cond.name);
+         for (const PseudoClass& pc : seg.token.pseudos) {
+             switch (pc.type) {
+             case PseudoClass::Visible: deps.properties.insert(QStringLiteral("visible"));     break;
+             case PseudoClass::Enabled: deps.properties.insert(QStringLiteral("enabled"));     break;
+             case PseudoClass::Focused: deps.properties.insert(QStringLiteral("activeFocus")); break;
+             case PseudoClass::Has:
+                 deps.relative = true;
+                 Q_FALLTHROUGH();
+             case PseudoClass::Not:
+                 for (const SelectorChain& sub : *pc.selectors)
+                     collectDependencies(sub, deps);
+                 break;
+             case PseudoClass::NthChild:
+             case PseudoClass::NthLastChild:
+                 break;
+             }
+         }
+     }
+ }
@@ -0,0 +1,183 @@
+/**
+ * UiSettleMonitor.cpp  —  Qt 5.15.x
+ *
+ * 界面静止检测：动画 / Loader 状态 + 帧交换间隔 + 未渲染的 polish。
+ * wait_idle 与动作的 settle 模式使用，替代客户端的固定等待。
+ */
+
+#include "UiSettleMonitor.h"
+
+#include "UiRenderThrottle.h"
+
+#include <QAbstractAnimation>
+#include <QCoreApplication>
+#include <QEvent>
+#include <QJsonArray>
+
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickWindow>
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// QtQuick 的 Loader.Loading
+const int kLoaderLoading = 2;
+
+bool isQmlAnimation(QObject* obj)
+{
+    return obj->inherits("QQuickAbstractAnimation") || obj->inherits("QQuickTransition");
+}
+
+}  // namespace
+
+UiSettleMonitor::UiSettleMonitor(QObject* parent)
+    : QObject(parent)
+{
+    clock_.start();
+    connect(&watcher_, &UiTreeWatcher::attached, this, &UiSettleMonitor::onAttached);
+}
+
+UiSettleMonitor::~UiSettleMonitor() = default;
+
+UiSettleMonitor::Options UiSettleMonitor::options(const QJsonObject& json)
+{
+    Options out;
+    out.quietMs = std::max(0, json.value(QStringLiteral("quietMs")).toInt(out.quietMs));
+    out.timeoutMs = std::max(0, json.value(QStringLiteral("timeoutMs")).toInt(out.timeoutMs));
+    return out;
+}
+
+void UiSettleMonitor::onAttached(QObject* obj)
+{
+    if (auto* window = qobject_cast<QQuickWindow*>(obj)) {
+        addWindow(window);
+        return;
+    }
+    if (qobject_cast<QAbstractAnimation*>(obj) || isQmlAnimation(obj)) {
+        animations_.insert(obj);
+    } else if (obj->inherits("QQuickLoader")) {
+        loaders_.insert(obj);
+    } else {
+        return;
+    }
+    connect(obj, &QObject::destroyed, this, &UiSettleMonitor::onObjectDestroyed, Qt::UniqueConnection);
+}
+
+void UiSettleMonitor::onObjectDestroyed(QObject* obj)
+{
+    animations_.remove(obj);
+    loaders_.remove(obj);
+    roots_.remove(obj);
+    windows_.remove(obj);
+    unrendered_.remove(static_cast<QQuickWindow*>(obj));
+}
+
+void UiSettleMonitor::addWindow(QQuickWindow* window)
+{
+    if (!window || windows_.contains(window)) return;
+    windows_.insert(window);
+    window->installEventFilter(this);
+    connect(window, &QObject::destroyed, this, &UiSettleMonitor::onObjectDestroyed);
+    // 线程化渲染循环中在渲染线程发出
+    connect(window, &QQuickWindow::frameSwapped, this, [this]() {
+        lastFrame_.store(clock_.elapsed());
+        ++frames_;
+    }, Qt::DirectConnection);
+}
+
+// 未曝光的窗口收到 UpdateRequest 时，渲染循环不做 polish 也不渲染
+bool UiSettleMonitor::eventFilter(QObject* watched, QEvent* event)
+{
+    if (event->type() == QEvent::UpdateRequest) {
+        auto* window = static_cast<QQuickWindow*>(watched);
+        if (!window->isExposed()) unrendered_.insert(window);
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void UiSettleMonitor::refresh(const QList<QObject*>& roots)
+{
+    for (QObject* root : roots) {
+        if (!root) continue;
+        // QQuickView 之类以内容项为根时，窗口不在子树里
+        if (auto* item = qobject_cast<QQuickItem*>(root)) addWindow(item->window());
+        if (roots_.contains(root)) continue;
+        roots_.insert(root);
+        connect(root, &QObject::destroyed, this, &UiSettleMonitor::onObjectDestroyed, Qt::UniqueConnection);
+        watcher_.watch(root);
+    }
+    watcher_.sync();
+}
+
+QStringList UiSettleMonitor::busy()
+{
+    QStringList out;
+    for (QObject* obj : animations_) {
+        const auto* animation = qobject_cast<QAbstractAnimation*>(obj);
+        const bool running = animation ? animation->state() == QAbstractAnimation::Running
+                                       : obj->property("running").toBool();
+        if (running) {
+            out.append(QStringLiteral("animations"));
+            break;
+        }
+    }
+    for (QObject* obj : loaders_) {
+        if (obj->property("status").toInt() == kLoaderLoading) {
+            out.append(QStringLiteral("loading"));
+            break;
+        }
+    }
+    // 重新曝光后渲染循环随即渲染，之后由帧交换覆盖
+    for (auto it = unrendered_.begin(); it != unrendered_.end();) {
+        it = (*it)->isExposed() ? unrendered_.erase(it) : std::next(it);
+    }
+    if (!unrendered_.isEmpty()) out.append(QStringLiteral("polish"));
+    return out;
+}
+
+// ────────────────────────────────────────────────────────────────
+//  wait — 轮询直到静止或超时
+//
+//  quietSince 在任一条件不满足、或补发了被节流拦下的更新时重置；
+//  静止时长取它与最后一次交换帧两者中较晚的一个起算。
+//  processEvents 本身最多阻塞 kPollMs，轮询之间不再额外休眠。
+// ────────────────────────────────────────────────────────────────
+QJsonObject UiSettleMonitor::wait(const QList<QObject*>& roots, const Options& options,
+                                  UiRenderThrottle* throttle)
+{
+    refresh(roots);
+
+    const int framesBefore = frames_.load();
+    const qint64 start = clock_.elapsed();
+    qint64 quietSince = start;
+    QStringList pending;
+    bool idle = false;
+    for (;;) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, kPollMs);
+        watcher_.sync();
+        const bool flushed = throttle && throttle->hasHeld();
+        if (flushed) throttle->flush();
+
+        const qint64 now = clock_.elapsed();
+        pending = busy();
+        if (!pending.isEmpty() || flushed) quietSince = now;
+        const qint64 lastActivity = std::max(quietSince, lastFrame_.load());
+        if (pending.isEmpty() && now - lastActivity >= options.quietMs) {
+            idle = true;
+            break;
+        }
+        if (now - start >= options.timeoutMs) {
+            if (pending.isEmpty()) pending.append(QStringLiteral("rendering"));
+            break;
+        }
+    }
+
+    QJsonObject out;
+    out.insert(QStringLiteral("idle"), idle);
+    out.insert(QStringLiteral("elapsedMs"), static_cast<double>(clock_.elapsed() - start));
+    out.insert(QStringLiteral("frames"), frames_.load() - framesBefore);
+    if (!idle) out.insert(QStringLiteral("pending"), QJsonArray::fromStringList(pending));
+    return out;
+}
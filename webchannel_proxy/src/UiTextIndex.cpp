@@ -0,0 +1,237 @@
+/**
+ * UiTextIndex.cpp  —  Qt 5.15.x
+ *
+ * 文本属性索引：精确哈希 + trigram 倒排，随 notify 信号增量维护。
+ * 处理器的 "text" / "title" 目标查找使用。
+ */
+
+#include "UiTextIndex.h"
+
+#include <QMetaProperty>
+#include <QVariant>
+#include <QVector>
+
+#include <algorithm>
+
+namespace {
+
+// obj 是否为 root 的 QObject 后代（含 root 自身），即 findChildren() 的范围
+bool objectWithin(QObject* obj, QObject* root)
+{
+    for (QObject* n = obj; n; n = n->parent()) {
+        if (n == root) return true;
+    }
+    return false;
+}
+
+// obj 在 root 的 QObject 子树内的先序位置（逐层的兄弟下标），
+// 字典序即 findChildren() 的顺序；root 自身为空路径
+QVector<int> documentPath(QObject* obj, QObject* root)
+{
+    QVector<int> path;
+    for (QObject* n = obj; n && n != root; n = n->parent()) {
+        QObject* parent = n->parent();
+        if (!parent) break;
+        path.prepend(parent->children().indexOf(n));
+    }
+    return path;
+}
+
+}  // namespace
+
+UiTextIndex::UiTextIndex(const QStringList& properties, QObject* parent)
+    : QObject(parent)
+    , properties_(properties)
+{
+    connect(&watcher_, &UiTreeWatcher::attached, this, &UiTextIndex::onAttached);
+    connect(&watcher_, &UiTreeWatcher::propertyChanged, this, &UiTextIndex::onPropertyChanged);
+    watcher_.addProperties(QSet<QString>(properties_.begin(), properties_.end()));
+}
+
+UiTextIndex::~UiTextIndex() = default;
+
+QSet<QString> UiTextIndex::grams(const QString& folded)
+{
+    QSet<QString> out;
+    for (int i = 0; i + kGramSize <= folded.size(); ++i) out.insert(folded.mid(i, kGramSize));
+    return out;
+}
+
+QStringList UiTextIndex::read(QObject* obj) const
+{
+    QStringList values;
+    values.reserve(properties_.size());
+    for (const QString& name : properties_) {
+        const QVariant v = obj->property(name.toLatin1().constData());
+        values.append(v.isValid() ? v.toString() : QString());
+    }
+    return values;
+}
+
+void UiTextIndex::onAttached(QObject* obj)
+{
+    connect(obj, &QObject::destroyed, this, &UiTextIndex::onObjectDestroyed);
+
+    const QMetaObject* mo = obj->metaObject();
+    for (const QString& name : qAsConst(properties_)) {
+        const int index = mo->indexOfProperty(name.toLatin1().constData());
+        if (index >= 0 && !mo->property(index).hasNotifySignal()) {
+            volatile_.insert(obj);
+            break;
+        }
+    }
+    reindex(obj);
+}
+
+void UiTextIndex::onPropertyChanged(QObject* obj)
+{
+    reindex(obj);
+}
+
+void UiTextIndex::onObjectDestroyed(QObject* obj)
+{
+    erase(obj);
+    volatile_.remove(obj);
+    roots_.remove(obj);
+}
+
+void UiTextIndex::reindex(QObject* obj)
+{
+    const QStringList values = read(obj);
+    const auto it = values_.constFind(obj);
+    if (it != values_.constEnd() && *it == values) return;
+    erase(obj);
+    insert(obj, values);
+}
+
+// 空值不入索引；同一对象的多个属性合并到同一组键上
+void UiTextIndex::insert(QObject* obj, const QStringList& values)
+{
+    bool any = false;
+    for (const QString& value : values) {
+        if (value.isEmpty()) continue;
+        any = true;
+        exact_[value].insert(obj);
+        const QString folded = value.toCaseFolded();
+        folded_[folded].insert(obj);
+        for (const QString& gram : grams(folded)) grams_[gram].insert(obj);
+    }
+    if (any) values_.insert(obj, values);
+}
+
+void UiTextIndex::erase(QObject* obj)
+{
+    const auto it = values_.find(obj);
+    if (it == values_.end()) return;
+
+    const auto drop = [obj](QHash<QString, QSet<QObject*>>& table, const QString& key) {
+        const auto entry = table.find(key);
+        if (entry == table.end()) return;
+        entry->remove(obj);
+        if (entry->isEmpty()) table.erase(entry);
+    };
+    for (const QString& value : qAsConst(*it)) {
+        if (value.isEmpty()) continue;
+        drop(exact_, value);
+        const QString folded = value.toCaseFolded();
+        drop(folded_, folded);
+        for (const QString& gram : grams(folded)) drop(grams_, gram);
+    }
+    values_.erase(it);
+}
+
+void UiTextIndex::refresh(const QList<QObject*>& roots)
+{
+    for (QObject* root : roots) {
+        if (!root || roots_.contains(root)) continue;
+        roots_.insert(root);
+        watcher_.watch(root);
+    }
+    watcher_.sync();
+    for (QObject* obj : qAsConst(volatile_)) reindex(obj);
+}
+
+// ────────────────────────────────────────────────────────────────
+//  candidates — 索引层面的候选集合（可能多于真实命中，由 matches 复核）
+// ────────────────────────────────────────────────────────────────
+QSet<QObject*> UiTextIndex::candidates(const QString& value, Match match, Qt::CaseSensitivity cs) const
+{
+    if (match == Match::Exact) {
+        return cs == Qt::CaseSensitive ? exact_.value(value) : folded_.value(value.toCaseFolded());
+    }
+
+    const QString folded = value.toCaseFolded();
+    if (folded.size() < kGramSize) {
+        QSet<QObject*> all;
+        for (auto it = values_.constBegin(); it != values_.constEnd(); ++it) all.insert(it.key());
+        return all;
+    }
+
+    // 从最小的倒排集合开始求交
+    QVector<const QSet<QObject*>*> lists;
+    for (const QString& gram : grams(folded)) {
+        const auto it = grams_.constFind(gram);
+        if (it == grams_.constEnd()) return {};
+        lists.append(&*it);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const QSet<QObject*>* a, const QSet<QObject*>* b) { return a->size() < b->size(); });
+
+    QSet<QObject*> result = *lists.first();
+    for (int i = 1; i < lists.size() && !result.isEmpty(); ++i) result.intersect(*lists.at(i));
+    return result;
+}
+
+bool UiTextIndex::matches(QObject* obj, const QString& value, Match match, Qt::CaseSensitivity cs) const
+{
+    for (const QString& current : read(obj)) {
+        if (current.isEmpty()) continue;
+        const bool hit = match == Match::Exact ? current.compare(value, cs) == 0
+                                               : current.contains(value, cs);
+        if (hit) return true;
+    }
+    return false;
+}
+
+QList<QObject*> UiTextIndex::findAll(const QList<QObject*>& roots, const QString& value,
+                                     Match match, Qt::CaseSensitivity cs)
+{
+    refresh(roots);
+    if (value.isEmpty()) return {};
+
+    // (根序号, 是否为根自身, 文档路径)：根自身排在其后代之后
+    struct Ranked {
+        int          root;
+        bool         isRoot;
+        QVector<int> path;
+        QObject*     obj;
+    };
+    QVector<Ranked> ranked;
+    for (QObject* obj : candidates(value, match, cs)) {
+        if (!matches(obj, value, match, cs)) continue;
+        for (int r = 0; r < roots.size(); ++r) {
+            QObject* root = roots.at(r);
+            if (!root || !objectWithin(obj, root)) continue;
+            if (obj == root && !includeRoots_) continue;
+            ranked.append({ r, obj == root, obj == root ? QVector<int>() : documentPath(obj, root), obj });
+            break;
+        }
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const Ranked& a, const Ranked& b) {
+        if (a.root != b.root) return a.root < b.root;
+        if (a.isRoot != b.isRoot) return b.isRoot;
+        return std::lexicographical_compare(a.path.begin(), a.path.end(), b.path.begin(), b.path.end());
+    });
+
+    QList<QObject*> out;
+    out.reserve(ranked.size());
+    for (const Ranked& r : qAsConst(ranked)) out.append(r.obj);
+    return out;
+}
+
+QObject* UiTextIndex::find(const QList<QObject*>& roots, const QString& value,
+                           Match match, Qt::CaseSensitivity cs)
+{
+    const QList<QObject*> all = findAll(roots, value, match, cs);
+    return all.isEmpty() ? nullptr : all.first();
+}
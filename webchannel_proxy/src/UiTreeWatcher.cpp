@@ -0,0 +1,328 @@
+/**
+ * UiTreeWatcher.cpp  —  Qt 5.15.x
+ *
+ * 对象树变化监听：结构 / 属性变化 → generation 计数 + 合并后的 scope 通知。
+ * 活动查询（UiLiveQuery）与 QmlQuerySelector 的结果缓存共用。
+ */
+
+#include "UiTreeWatcher.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QMetaProperty>
+#include <QTimer>
+#include <QVarLengthArray>
+
+#include <QtQuick/QQuickItem>
+
+// ════════════════════════════════════════════════════════════════
+//  UiTreeWatcherHub — 所有 watcher 共用的应用级事件过滤器
+//
+//  先按事件类型筛掉无关事件，再查一次表找到监听该对象的 watcher。
+//  挂在 QCoreApplication 下，随应用对象销毁。
+// ════════════════════════════════════════════════════════════════
+class UiTreeWatcherHub : public QObject {
+public:
+    static UiTreeWatcherHub* instance()
+    {
+        if (!current_ && QCoreApplication::instance()) {
+            auto* hub = new UiTreeWatcherHub(QCoreApplication::instance());
+            QCoreApplication::instance()->installEventFilter(hub);
+        }
+        return current_;
+    }
+    // 只在 hub 已存在时返回（析构路径上不新建）
+    static UiTreeWatcherHub* existing() { return current_; }
+
+    void add(QObject* obj, UiTreeWatcher* watcher) { watchers_[obj].append(watcher); }
+
+    void remove(QObject* obj, UiTreeWatcher* watcher)
+    {
+        const auto it = watchers_.find(obj);
+        if (it == watchers_.end()) return;
+        Watchers& list = *it;
+        for (int i = 0; i < list.size(); ++i) {
+            if (list[i] != watcher) continue;
+            list[i] = list[list.size() - 1];
+            list.removeLast();
+            break;
+        }
+        if (list.isEmpty()) watchers_.erase(it);
+    }
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override
+    {
+        switch (event->type()) {
+        case QEvent::ChildAdded:
+        case QEvent::ChildRemoved:
+        case QEvent::Show:
+        case QEvent::Hide:
+        case QEvent::EnabledChange:
+        case QEvent::FocusIn:
+        case QEvent::FocusOut:
+        case QEvent::DynamicPropertyChange: {
+            const auto it = watchers_.constFind(watched);
+            if (it == watchers_.constEnd()) break;
+            // 处理过程中可能增删登记，先复制
+            const Watchers list = *it;
+            for (UiTreeWatcher* watcher : list) watcher->handleEvent(watched, event);
+            break;
+        }
+        default:
+            break;
+        }
+        return QObject::eventFilter(watched, event);
+    }
+
+private:
+    using Watchers = QVarLengthArray<UiTreeWatcher*, 4>;
+
+    explicit UiTreeWatcherHub(QObject* parent) : QObject(parent) { current_ = this; }
+    ~UiTreeWatcherHub() override { current_ = nullptr; }
+
+    static UiTreeWatcherHub* current_;
+    QHash<QObject*, Watchers> watchers_;
+};
+
+UiTreeWatcherHub* UiTreeWatcherHub::current_ = nullptr;
+
+UiTreeWatcher::UiTreeWatcher(QObject* parent)
+    : QObject(parent)
+{
+    notifySlot_ = staticMetaObject.method(staticMetaObject.indexOfSlot("onPropertyNotify()"));
+}
+
+UiTreeWatcher::~UiTreeWatcher()
+{
+    if (UiTreeWatcherHub* hub = UiTreeWatcherHub::existing()) {
+        for (QObject* obj : qAsConst(known_)) hub->remove(obj, this);
+    }
+}
+
+QObject* UiTreeWatcher::logicalParent(QObject* obj)
+{
+    if (!obj) return nullptr;
+    if (auto* item = qobject_cast<QQuickItem*>(obj)) {
+        if (QQuickItem* parentItem = item->parentItem()) return parentItem;
+    }
+    return obj->parent();
+}
+
+bool UiTreeWatcher::isWithin(QObject* node, QObject* scope)
+{
+    for (QObject* n = node; n; n = logicalParent(n)) {
+        if (n == scope) return true;
+    }
+    return false;
+}
+
+// ────────────────────────────────────────────────────────────────
+//  watch — 迭代遍历子树，未监听的节点逐个 attach
+//
+//  显式 watch 的根可能已部分监听（例如曾作为别的根的子树），
+//  已监听的节点仍要向下遍历；结构变化后的增量纳入走 watchNew()。
+// ────────────────────────────────────────────────────────────────
+void UiTreeWatcher::watch(QObject* root)
+{
+    if (!root) return;
+
+    QSet<QObject*> visited;
+    QList<QObject*> stack{ root };
+    while (!stack.isEmpty()) {
+        QObject* obj = stack.takeLast();
+        if (visited.contains(obj)) continue;
+        visited.insert(obj);
+        if (!known_.contains(obj)) attach(obj);
+
+        for (QObject* child : obj->children()) stack.append(child);
+        if (auto* item = qobject_cast<QQuickItem*>(obj)) {
+            for (QQuickItem* child : item->childItems()) stack.append(child);
+        }
+    }
+}
+
+// 已监听的节点下新增的子节点各自会产生 ChildAdded / childrenChanged，
+// 所以遇到已监听的节点不必再向下走
+void UiTreeWatcher::watchNew(QObject* obj)
+{
+    QList<QObject*> stack{ obj };
+    while (!stack.isEmpty()) {
+        QObject* n = stack.takeLast();
+        if (known_.contains(n)) continue;
+        attach(n);
+
+        for (QObject* child : n->children()) stack.append(child);
+        if (auto* item = qobject_cast<QQuickItem*>(n)) {
+            for (QQuickItem* child : item->childItems()) stack.append(child);
+        }
+    }
+}
+
+void UiTreeWatcher::addProperties(const QSet<QString>& names)
+{
+    QSet<QString> added;
+    for (const QString& name : names) {
+        if (!properties_.contains(name)) added.insert(name);
+    }
+    if (added.isEmpty()) return;
+
+    properties_.unite(added);
+    for (QObject* obj : qAsConst(known_)) connectProperties(obj, added);
+}
+
+bool UiTreeWatcher::isObservable(const QString& name, QObject* root) const
+{
+    const auto it = unobservable_.constFind(name);
+    if (it == unobservable_.constEnd()) return true;
+    for (QObject* obj : *it) {
+        if (isWithin(obj, root)) return false;
+    }
+    return true;
+}
+
+void UiTreeWatcher::attach(QObject* obj)
+{
+    known_.insert(obj);
+    if (UiTreeWatcherHub* hub = UiTreeWatcherHub::instance()) hub->add(obj, this);
+    connect(obj, &QObject::destroyed, this, &UiTreeWatcher::onDestroyed);
+    if (auto* item = qobject_cast<QQuickItem*>(obj))
+        connect(item, &QQuickItem::childrenChanged, this, &UiTreeWatcher::onItemChildrenChanged);
+    connectProperties(obj, properties_);
+    emit attached(obj);
+}
+
+void UiTreeWatcher::connectProperties(QObject* obj, const QSet<QString>& names)
+{
+    const QMetaObject* mo = obj->metaObject();
+    for (const QString& name : names) {
+        const int index = mo->indexOfProperty(name.toLatin1().constData());
+        if (index < 0) continue;
+        const QMetaProperty prop = mo->property(index);
+        if (prop.hasNotifySignal()) {
+            connect(obj, prop.notifySignal(), this, notifySlot_, Qt::UniqueConnection);
+            continue;
+        }
+        // QWidget 的显隐 / 可用状态由 eventFilter 里的事件覆盖
+        if (obj->isWidgetType()
+            && (name == QLatin1String("visible") || name == QLatin1String("enabled")))
+            continue;
+        unobservable_[name].insert(obj);
+        ++generation_;
+    }
+}
+
+// ────────────────────────────────────────────────────────────────
+//  handleEvent — 共享过滤器分发来的已监听对象上的事件
+//
+//  控件状态事件只在对应属性被登记时才计为变化，
+//  避免无关的显隐 / 焦点切换冲刷缓存。
+// ────────────────────────────────────────────────────────────────
+void UiTreeWatcher::handleEvent(QObject* watched, QEvent* event)
+{
+    switch (event->type()) {
+    case QEvent::ChildAdded:
+        markStructure(watched, static_cast<QChildEvent*>(event)->child());
+        break;
+    case QEvent::ChildRemoved:
+        markStructure(watched);
+        break;
+    case QEvent::Show:
+    case QEvent::Hide:
+        if (properties_.contains(QStringLiteral("visible"))) markProperty(watched);
+        break;
+    case QEvent::EnabledChange:
+        if (properties_.contains(QStringLiteral("enabled"))) markProperty(watched);
+        break;
+    case QEvent::FocusIn:
+    case QEvent::FocusOut:
+        if (properties_.contains(QStringLiteral("activeFocus"))) markProperty(watched);
+        break;
+    case QEvent::DynamicPropertyChange: {
+        const auto* e = static_cast<QDynamicPropertyChangeEvent*>(event);
+        if (properties_.contains(QString::fromLatin1(e->propertyName()))) markProperty(watched);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void UiTreeWatcher::onItemChildrenChanged()
+{
+    QObject* item = sender();
+    if (!item) return;
+    pendingItems_.insert(item);
+    markStructure(item);
+}
+
+void UiTreeWatcher::onPropertyNotify()
+{
+    if (QObject* obj = sender()) markProperty(obj);
+}
+
+void UiTreeWatcher::onDestroyed(QObject* obj)
+{
+    known_.remove(obj);
+    dirty_.remove(obj);
+    pendingItems_.remove(obj);
+    if (UiTreeWatcherHub* hub = UiTreeWatcherHub::existing()) hub->remove(obj, this);
+    for (auto it = unobservable_.begin(); it != unobservable_.end();) {
+        it->remove(obj);
+        if (it->isEmpty()) it = unobservable_.erase(it);
+        else ++it;
+    }
+}
+
+void UiTreeWatcher::markStructure(QObject* parent, QObject* added)
+{
+    ++generation_;
+    dirty_.insert(parent);
+    if (added) pendingChildren_.append(added);
+    queueFlush();
+}
+
+void UiTreeWatcher::markProperty(QObject* obj)
+{
+    ++generation_;
+    QObject* parent = logicalParent(obj);
+    dirty_.insert(parent && known_.contains(parent) ? parent : obj);
+    queueFlush();
+    emit propertyChanged(obj);
+}
+
+void UiTreeWatcher::queueFlush()
+{
+    if (flushQueued_) return;
+    flushQueued_ = true;
+    QTimer::singleShot(0, this, &UiTreeWatcher::flush);
+}
+
+void UiTreeWatcher::sync()
+{
+    const QVector<QPointer<QObject>> children = pendingChildren_;
+    const QSet<QObject*> items = pendingItems_;
+    pendingChildren_.clear();
+    pendingItems_.clear();
+    // 合并前又被移出监听范围的子对象不纳入
+    for (const QPointer<QObject>& child : children) {
+        if (child && known_.contains(child->parent())) watchNew(child);
+    }
+    for (QObject* obj : items) {
+        if (auto* item = qobject_cast<QQuickItem*>(obj)) {
+            for (QQuickItem* child : item->childItems()) watchNew(child);
+        }
+    }
+}
+
+// ChildAdded 在子对象构造期间发送，此时元对象尚不完整；
+// 延迟到这里再把新子树纳入监听
+void UiTreeWatcher::flush()
+{
+    flushQueued_ = false;
+    sync();
+
+    const QList<QObject*> scopes = dirty_.values();
+    dirty_.clear();
+    if (!scopes.isEmpty()) emit changed(scopes);
+}
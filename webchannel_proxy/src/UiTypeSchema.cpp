@@ -0,0 +1,138 @@
+/**
+ * UiTypeSchema.cpp  —  Qt 5.15.x
+ *
+ * describe_type：类型的属性 / 方法元数据，按类名缓存。
+ */
+
+#include "UiTypeSchema.h"
+#include "UiSelectorEngine.h"
+
+#include <QJsonArray>
+#include <QMetaMethod>
+#include <QMetaObject>
+#include <QMetaProperty>
+#include <QMetaType>
+#include <QObject>
+
+namespace {
+
+QJsonArray toJsonArray(const QList<QByteArray>& list)
+{
+    QJsonArray out;
+    for (const QByteArray& item : list) out.append(QString::fromLatin1(item));
+    return out;
+}
+
+// index 处成员由哪个类声明：沿父类链找偏移量不大于 index 的最深一层
+template <typename OffsetFn>
+QString ownerOf(const QMetaObject* mo, int index, OffsetFn offset)
+{
+    for (const QMetaObject* m = mo; m; m = m->superClass()) {
+        if (index >= offset(m)) return QString::fromLatin1(m->className());
+    }
+    return QString();
+}
+
+QString methodKind(QMetaMethod::MethodType type)
+{
+    switch (type) {
+    case QMetaMethod::Signal: return QStringLiteral("signal");
+    case QMetaMethod::Slot:   return QStringLiteral("slot");
+    default:                  return QStringLiteral("method");
+    }
+}
+
+}  // namespace
+
+QJsonObject UiTypeSchema::build(const QMetaObject* mo)
+{
+    QJsonObject out;
+    out.insert(QStringLiteral("className"), QString::fromLatin1(mo->className()));
+    out.insert(QStringLiteral("qmlName"), SelectorDetail::resolveQmlTypeName(mo->className()));
+
+    QJsonArray inherits;
+    for (const QMetaObject* m = mo->superClass(); m; m = m->superClass())
+        inherits.append(QString::fromLatin1(m->className()));
+    out.insert(QStringLiteral("inherits"), inherits);
+
+    QJsonArray properties;
+    for (int i = 0; i < mo->propertyCount(); ++i) {
+        const QMetaProperty prop = mo->property(i);
+        QJsonObject entry;
+        entry.insert(QStringLiteral("name"), QString::fromLatin1(prop.name()));
+        entry.insert(QStringLiteral("type"), QString::fromLatin1(prop.typeName()));
+        entry.insert(QStringLiteral("readable"), prop.isReadable());
+        entry.insert(QStringLiteral("writable"), prop.isWritable());
+        entry.insert(QStringLiteral("notify"), prop.hasNotifySignal()
+                                                   ? QJsonValue(QString::fromLatin1(prop.notifySignal().methodSignature()))
+                                                   : QJsonValue());
+        entry.insert(QStringLiteral("owner"),
+                     ownerOf(mo, i, [](const QMetaObject* meta) { return meta->propertyOffset(); }));
+        properties.append(entry);
+    }
+    out.insert(QStringLiteral("properties"), properties);
+
+    QJsonArray methods;
+    for (int i = 0; i < mo->methodCount(); ++i) {
+        const QMetaMethod method = mo->method(i);
+        if (method.access() != QMetaMethod::Public || method.methodType() == QMetaMethod::Constructor) continue;
+        QJsonObject entry;
+        entry.insert(QStringLiteral("name"), QString::fromLatin1(method.name()));
+        entry.insert(QStringLiteral("signature"), QString::fromLatin1(method.methodSignature()));
+        entry.insert(QStringLiteral("kind"), methodKind(method.methodType()));
+        entry.insert(QStringLiteral("returnType"), QString::fromLatin1(method.typeName()));
+        entry.insert(QStringLiteral("parameterTypes"), toJsonArray(method.parameterTypes()));
+        entry.insert(QStringLiteral("parameterNames"), toJsonArray(method.parameterNames()));
+        entry.insert(QStringLiteral("owner"),
+                     ownerOf(mo, i, [](const QMetaObject* meta) { return meta->methodOffset(); }));
+        methods.append(entry);
+    }
+    out.insert(QStringLiteral("methods"), methods);
+    return out;
+}
+
+QJsonObject UiTypeSchema::describe(const QMetaObject* mo)
+{
+    if (!mo) return {};
+    Entry& entry = cache_[QString::fromLatin1(mo->className())];
+    if (entry.propertyCount != mo->propertyCount() || entry.methodCount != mo->methodCount()) {
+        entry.propertyCount = mo->propertyCount();
+        entry.methodCount = mo->methodCount();
+        entry.schema = build(mo);
+    }
+    return entry.schema;
+}
+
+QJsonObject UiTypeSchema::describe(const QString& className, const QList<QObject*>& roots)
+{
+    return describe(find(className, roots));
+}
+
+bool UiTypeSchema::matchesName(const QMetaObject* mo, const QString& name)
+{
+    return name == QLatin1String(mo->className())
+        || name == SelectorDetail::resolveQmlTypeName(mo->className());
+}
+
+const QMetaObject* UiTypeSchema::find(const QString& className, const QList<QObject*>& roots)
+{
+    if (className.isEmpty()) return nullptr;
+
+    const int typeId = QMetaType::type((className + QLatin1Char('*')).toLatin1().constData());
+    if (typeId != QMetaType::UnknownType) {
+        if (const QMetaObject* mo = QMetaType::metaObjectForType(typeId)) return mo;
+    }
+
+    // 实例的元对象，或其父类链上同名的一层（如按 "Item" 找到 QQuickItem）
+    for (QObject* root : roots) {
+        if (!root) continue;
+        QList<QObject*> objs = root->findChildren<QObject*>();
+        objs.prepend(root);
+        for (QObject* obj : qAsConst(objs)) {
+            for (const QMetaObject* mo = obj->metaObject(); mo; mo = mo->superClass()) {
+                if (matchesName(mo, className)) return mo;
+            }
+        }
+    }
+    return nullptr;
+}
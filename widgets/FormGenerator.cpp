@@ -0,0 +1,117 @@
+#include "FormGenerator.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPushButton>
+#include <QScrollArea>
+#include <QSpinBox>
+#include <QStringList>
+#include <QTabWidget>
+#include <QVBoxLayout>
+
+namespace {
+// 每个分组：QGroupBox + 字段行(QLabel + 输入) + 应用按钮
+int widgetsPerGroup(const FormGeneratorConfig &config) {
+    return 1 + 2 * config.fieldsPerSection + 1;
+}
+
+// 轮换输入控件类型，使树中包含多种类名（便于按类名/文本定位的基准）
+QWidget *makeInput(int field) {
+    switch (field % 4) {
+    case 0:
+        return new QLineEdit();
+    case 1: {
+        auto *combo = new QComboBox();
+        combo->addItems({QStringLiteral("admin"), QStringLiteral("editor"), QStringLiteral("viewer")});
+        return combo;
+    }
+    case 2:
+        return new QCheckBox(QStringLiteral("启用"));
+    default: {
+        auto *spin = new QSpinBox();
+        spin->setRange(0, 1000);
+        return spin;
+    }
+    }
+}
+
+QGroupBox *buildSection(const FormGeneratorConfig &config, int tab, int section, int depth) {
+    auto *group = new QGroupBox(QStringLiteral("Section %1.%2.%3").arg(tab).arg(section).arg(depth));
+    group->setObjectName(QStringLiteral("gen_t%1_s%2_d%3").arg(tab).arg(section).arg(depth));
+    auto *layout = new QFormLayout(group);
+
+    for (int f = 0; f < config.fieldsPerSection; ++f) {
+        auto *label = new QLabel(generatedFieldText(tab, section, depth, f));
+        label->setObjectName(generatedFieldName(tab, section, depth, f, "label"));
+        QWidget *input = makeInput(f);
+        input->setObjectName(generatedFieldName(tab, section, depth, f, "input"));
+        layout->addRow(label, input);
+    }
+
+    auto *apply = new QPushButton(QStringLiteral("Apply %1.%2.%3").arg(tab).arg(section).arg(depth));
+    apply->setObjectName(QStringLiteral("gen_t%1_s%2_d%3_apply").arg(tab).arg(section).arg(depth));
+    layout->addRow(apply);
+
+    if (depth < config.nesting) {
+        layout->addRow(buildSection(config, tab, section, depth + 1));
+    }
+    return group;
+}
+}  // namespace
+
+int FormGeneratorConfig::estimatedWidgetCount() const {
+    const int perTab = sections * (nesting + 1) * widgetsPerGroup(*this) + 3;  // scroll + page + list
+    return 1 + tabs * perTab;
+}
+
+FormGeneratorConfig FormGeneratorConfig::forWidgetCount(int target, const FormGeneratorConfig &base) {
+    FormGeneratorConfig config = base;
+    const int perSection = (config.nesting + 1) * widgetsPerGroup(config);
+    config.sections = qMax(1, qRound(static_cast<double>(target) / (config.tabs * perSection)));
+    return config;
+}
+
+QString generatedFieldName(int tab, int section, int depth, int field, const char *suffix) {
+    return QStringLiteral("gen_t%1_s%2_d%3_f%4_%5")
+        .arg(tab).arg(section).arg(depth).arg(field).arg(QLatin1String(suffix));
+}
+
+QString generatedFieldText(int tab, int section, int depth, int field) {
+    return QStringLiteral("Field %1.%2.%3.%4").arg(tab).arg(section).arg(depth).arg(field);
+}
+
+QWidget *generateForm(const FormGeneratorConfig &config, QWidget *parent) {
+    auto *tabs = new QTabWidget(parent);
+    tabs->setObjectName(QStringLiteral("generatedTabs"));
+
+    for (int t = 0; t < config.tabs; ++t) {
+        auto *page = new QWidget();
+        page->setObjectName(QStringLiteral("gen_t%1_page").arg(t));
+        auto *pageLayout = new QVBoxLayout(page);
+        for (int s = 0; s < config.sections; ++s) {
+            pageLayout->addWidget(buildSection(config, t, s, 0));
+        }
+
+        auto *list = new QListWidget();
+        list->setObjectName(QStringLiteral("gen_t%1_list").arg(t));
+        QStringList rows;
+        rows.reserve(config.listItems);
+        for (int i = 0; i < config.listItems; ++i) {
+            rows.append(QStringLiteral("Row %1.%2").arg(t).arg(i));
+        }
+        list->addItems(rows);
+        pageLayout->addWidget(list);
+
+        auto *scroll = new QScrollArea();
+        scroll->setObjectName(QStringLiteral("gen_t%1_scroll").arg(t));
+        scroll->setWidgetResizable(true);
+        scroll->setWidget(page);
+        tabs->addTab(scroll, QStringLiteral("Tab %1").arg(t));
+    }
+    return tabs;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QString>
+
+class QWidget;
+
+// 大表单生成器：用于压测 QtGenericUiAutomationHandler 在上万控件规模下的表现。
+//
+// 结构：QTabWidget(tabs 页) → 每页 QScrollArea → sections 个 QGroupBox，
+//       每个分组内 fieldsPerSection 行「QLabel + 输入控件」和一个应用按钮，
+//       并向下嵌套 nesting 层子分组；每页末尾附带一个 listItems 行的 QListWidget。
+//
+// objectName 规则（供基准与脚本稳定定位）：
+//   gen_t{页}_s{分组}_d{嵌套层}_f{字段}_label / _input
+//   gen_t{页}_s{分组}_d{嵌套层}_apply
+//   gen_t{页}_list
+// 字段标签文本为 "Field t.s.d.f"，按钮文本为 "Apply t.s.d"。
+struct FormGeneratorConfig {
+    int tabs = 4;
+    int sections = 10;
+    int fieldsPerSection = 10;
+    int nesting = 2;
+    int listItems = 50;
+
+    // 不含 QComboBox/QSpinBox 内部子控件的估算值
+    int estimatedWidgetCount() const;
+
+    // 沿用 base 的其他维度，只调整 sections 使控件数接近 target
+    static FormGeneratorConfig forWidgetCount(int target, const FormGeneratorConfig &base = FormGeneratorConfig());
+};
+
+QWidget *generateForm(const FormGeneratorConfig &config, QWidget *parent = nullptr);
+
+QString generatedFieldName(int tab, int section, int depth, int field, const char *suffix);
+QString generatedFieldText(int tab, int section, int depth, int field);
@@ -1,6 +1,9 @@
 #include "UiAutomationProxyServer.h"
+#include "FormGenerator.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
 #include <QMainWindow>
 #include <QStackedWidget>
 #include <QFormLayout>
@@ -19,6 +22,7 @@
 #include <QListWidgetItem>
 #include <QStringList>
 #include <QMessageBox>
+#include <QScopedPointer>
 
 // 用于保存用户状态的结构体
 struct UserState {
@@ -306,14 +310,55 @@ private slots:
 };
 
 int main(int argc, char *argv[]) {
+    // 平台插件必须在 QApplication 构造前确定
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--offscreen") == 0 && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
     QApplication app(argc, argv);
-    
-    WidgetsDemoWindow window;
-    window.show();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Widgets demo and stress fixture"));
+    parser.addHelpOption();
+    const QCommandLineOption offscreenOpt(QStringLiteral("offscreen"), QStringLiteral("Run on the offscreen platform."));
+    const QCommandLineOption generateOpt(QStringLiteral("generate"),
+                                         QStringLiteral("Build a generated form with about this many widgets."),
+                                         QStringLiteral("widgets"));
+    const QCommandLineOption tabsOpt(QStringLiteral("tabs"), QStringLiteral("Generated form tab count."), QStringLiteral("n"));
+    const QCommandLineOption nestingOpt(QStringLiteral("nesting"), QStringLiteral("Generated group box nesting."), QStringLiteral("n"));
+    const QCommandLineOption fieldsOpt(QStringLiteral("fields"), QStringLiteral("Fields per generated group box."), QStringLiteral("n"));
+    const QCommandLineOption listOpt(QStringLiteral("list-items"), QStringLiteral("QListWidget rows per tab."), QStringLiteral("n"));
+    const QCommandLineOption portOpt(QStringLiteral("proxy-port"), QStringLiteral("Proxy port."), QStringLiteral("port"),
+                                     QStringLiteral("12345"));
+    parser.addOptions({offscreenOpt, generateOpt, tabsOpt, nestingOpt, fieldsOpt, listOpt, portOpt});
+    parser.process(app);
+
+    QScopedPointer<QMainWindow> window;
+    if (parser.isSet(generateOpt)) {
+        // 先应用各维度的覆盖，再据此推算 sections
+        FormGeneratorConfig base;
+        if (parser.isSet(tabsOpt)) base.tabs = qMax(1, parser.value(tabsOpt).toInt());
+        if (parser.isSet(nestingOpt)) base.nesting = qMax(0, parser.value(nestingOpt).toInt());
+        if (parser.isSet(fieldsOpt)) base.fieldsPerSection = qMax(1, parser.value(fieldsOpt).toInt());
+        if (parser.isSet(listOpt)) base.listItems = qMax(0, parser.value(listOpt).toInt());
+        const FormGeneratorConfig config = FormGeneratorConfig::forWidgetCount(parser.value(generateOpt).toInt(), base);
+
+        window.reset(new QMainWindow());
+        window->setObjectName("generatedFormWindow");
+        window->setWindowTitle("Widgets Generated Form");
+        window->resize(1024, 768);
+        window->setCentralWidget(generateForm(config));
+        qInfo() << "Generated form with" << window->findChildren<QWidget *>().size() << "widgets";
+    } else {
+        window.reset(new WidgetsDemoWindow());
+    }
+    window->show();
 
     UiAutomationProxyServer proxy;
-    proxy.useDefaultQtHandler(&window);
-    proxy.start(12345, QHostAddress::LocalHost, QStringLiteral("demo-token"));
+    proxy.useDefaultQtHandler(window.data());
+    proxy.start(static_cast<quint16>(parser.value(portOpt).toUInt()), QHostAddress::LocalHost, QStringLiteral("demo-token"));
     
     return app.exec();
 }